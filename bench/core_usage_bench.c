@@ -0,0 +1,142 @@
+// Benchmark: per-core usage deltas between two /proc/stat samples.
+// Compares a scalar loop over one CPUStats struct per core with
+// calculate_core_usage on the structure-of-arrays layout.
+//
+// Build with `make bench`, run bin/core_usage_bench.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../include/cpu_monitor.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// The straightforward version: walk an array of structs, one core at a time
+static void scalar_core_usage(const CPUStats *prev, const CPUStats *curr, int count,
+                              float *busy, float *iowait, float *steal, float *irq) {
+    for (int i = 0; i < count; i++) {
+        unsigned long user = curr[i].user - prev[i].user;
+        unsigned long nice = curr[i].nice - prev[i].nice;
+        unsigned long system = curr[i].system - prev[i].system;
+        unsigned long idle = curr[i].idle - prev[i].idle;
+        unsigned long io = curr[i].iowait - prev[i].iowait;
+        unsigned long hardirq = curr[i].irq - prev[i].irq;
+        unsigned long softirq = curr[i].softirq - prev[i].softirq;
+        unsigned long stolen = curr[i].steal - prev[i].steal;
+        unsigned long total = user + nice + system + idle + io + hardirq + softirq + stolen;
+
+        if (total == 0) {
+            busy[i] = iowait[i] = steal[i] = irq[i] = 0.0f;
+            continue;
+        }
+        busy[i] = 100.0f * (total - idle - io) / total;
+        iowait[i] = 100.0f * io / total;
+        steal[i] = 100.0f * stolen / total;
+        irq[i] = 100.0f * (hardirq + softirq) / total;
+    }
+}
+
+// Fill one sample with plausible counters, in both layouts
+static void make_sample(CPUStats *aos, CoreStats *soa, int count, const CPUStats *base) {
+    for (int i = 0; i < count; i++) {
+        CPUStats *c = &aos[i];
+        if (base) {
+            *c = base[i];
+            c->user += rand() % 150;
+            c->nice += rand() % 5;
+            c->system += rand() % 40;
+            c->idle += rand() % 200;
+            c->iowait += rand() % 10;
+            c->irq += rand() % 3;
+            c->softirq += rand() % 8;
+            c->steal += rand() % 4;
+        } else {
+            c->user = 1000000UL + rand();
+            c->nice = rand() % 10000;
+            c->system = 500000UL + rand() % 100000;
+            c->idle = 50000000UL + rand();
+            c->iowait = rand() % 50000;
+            c->irq = rand() % 1000;
+            c->softirq = rand() % 20000;
+            c->steal = rand() % 5000;
+        }
+
+        const unsigned long fields[CORE_FIELD_COUNT] = {
+            c->user, c->nice, c->system, c->idle, c->iowait, c->irq, c->softirq, c->steal
+        };
+        for (int f = 0; f < CORE_FIELD_COUNT; f++) {
+            soa->counters[f * soa->stride + i] = fields[f];
+        }
+    }
+    soa->count = count;
+}
+
+int main(void) {
+    const int sizes[] = {8, 64, 256, 1024, 4096};
+
+    srand(42);
+    printf("%-8s %14s %14s %10s %12s\n", "cores", "scalar ns/cyc", "soa ns/cyc", "speedup", "max error");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int n = sizes[s];
+        int stride = (n + CORE_LANES - 1) / CORE_LANES * CORE_LANES;
+        CPUStats *aos_prev = calloc(n, sizeof(CPUStats));
+        CPUStats *aos_curr = calloc(n, sizeof(CPUStats));
+        CoreStats prev = { calloc((size_t)CORE_FIELD_COUNT * stride, sizeof(uint64_t)), stride, 0 };
+        CoreStats curr = { calloc((size_t)CORE_FIELD_COUNT * stride, sizeof(uint64_t)), stride, 0 };
+        float *scalar = calloc((size_t)4 * stride, sizeof(float));
+        float *shares = calloc((size_t)4 * stride, sizeof(float));
+        if (!aos_prev || !aos_curr || !prev.counters || !curr.counters || !scalar || !shares) {
+            fprintf(stderr, "Allocation failed\n");
+            return 1;
+        }
+        CoreUsage usage = { shares, shares + stride, shares + 2 * stride, shares + 3 * stride };
+
+        make_sample(aos_prev, &prev, n, NULL);
+        make_sample(aos_curr, &curr, n, aos_prev);
+
+        // Enough repetitions for a few milliseconds of work per variant
+        int reps = 20000000 / n;
+        double t0 = now_sec();
+        for (int r = 0; r < reps; r++) {
+            scalar_core_usage(aos_prev, aos_curr, n, scalar, scalar + stride,
+                              scalar + 2 * stride, scalar + 3 * stride);
+            __asm__ volatile("" : : "r"(scalar) : "memory");
+        }
+        double scalar_ns = (now_sec() - t0) / reps * 1e9;
+
+        t0 = now_sec();
+        for (int r = 0; r < reps; r++) {
+            calculate_core_usage(&prev, &curr, &usage);
+            __asm__ volatile("" : : "r"(shares) : "memory");
+        }
+        double soa_ns = (now_sec() - t0) / reps * 1e9;
+
+        float max_error = 0.0f;
+        for (int m = 0; m < 4; m++) {
+            for (int i = 0; i < n; i++) {
+                float err = fabsf(scalar[m * stride + i] - shares[m * stride + i]);
+                if (err > max_error) max_error = err;
+            }
+        }
+        if (max_error > 0.01f) {
+            fprintf(stderr, "Mismatch at %d cores: max error %.4f%%\n", n, max_error);
+            return 1;
+        }
+        printf("%-8d %14.1f %14.1f %9.1fx %11.5f%%\n",
+               n, scalar_ns, soa_ns, scalar_ns / soa_ns, max_error);
+
+        free(aos_prev);
+        free(aos_curr);
+        free(prev.counters);
+        free(curr.counters);
+        free(scalar);
+        free(shares);
+    }
+    return 0;
+}
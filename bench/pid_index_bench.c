@@ -0,0 +1,128 @@
+// Benchmark: matching this cycle's processes against last cycle's.
+// Compares the old nested O(n*m) scan with the persistent PID index.
+//
+// Build with `make bench`, run bin/pid_index_bench.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../include/pid_index.h"
+
+typedef struct {
+    pid_t pid;
+    unsigned long starttime;
+    unsigned long ticks;
+    float cpu_usage;
+} SyntheticProc;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Build a previous/current pair: ~2% of processes exit and their PIDs are
+// reused by new processes with a later starttime, like a busy host.
+static void make_cycle(SyntheticProc *prev, SyntheticProc *curr, int n) {
+    for (int i = 0; i < n; i++) {
+        prev[i].pid = 300 + i * 3;
+        prev[i].starttime = 1000 + (unsigned long)rand() % 100000;
+        prev[i].ticks = (unsigned long)rand() % 100000;
+        curr[i] = prev[i];
+        curr[i].ticks += (unsigned long)rand() % 200;
+        if (rand() % 50 == 0) {
+            curr[i].starttime += 200000;  // PID reused by a new process
+        }
+    }
+    // Rotate the current list a bit so matches are not always at j == i
+    int shift = n / 7;
+    SyntheticProc *tmp = malloc(n * sizeof(SyntheticProc));
+    for (int i = 0; i < n; i++) tmp[i] = curr[(i + shift) % n];
+    for (int i = 0; i < n; i++) curr[i] = tmp[i];
+    free(tmp);
+}
+
+static long nested_match(SyntheticProc *prev, SyntheticProc *curr, int n) {
+    long matched = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (curr[i].pid == prev[j].pid && curr[i].starttime == prev[j].starttime) {
+                curr[i].cpu_usage = (float)(curr[i].ticks - prev[j].ticks);
+                matched++;
+                break;
+            }
+        }
+    }
+    return matched;
+}
+
+static long indexed_match(PidIndex *index, SyntheticProc *prev, SyntheticProc *curr, int n) {
+    long matched = 0;
+    for (int i = 0; i < n; i++) {
+        int j = pid_index_lookup(index, curr[i].pid, curr[i].starttime);
+        if (j >= 0) {
+            curr[i].cpu_usage = (float)(curr[i].ticks - prev[j].ticks);
+            matched++;
+        }
+    }
+    // Re-key on the current list, as the collector does every cycle
+    pid_index_clear(index);
+    for (int i = 0; i < n; i++) {
+        pid_index_insert(index, curr[i].pid, curr[i].starttime, i);
+    }
+    return matched;
+}
+
+int main(void) {
+    const int sizes[] = {1000, 10000, 100000};
+
+    srand(42);
+    printf("%-10s %14s %14s %10s %10s\n",
+           "procs", "nested us/cyc", "index us/cyc", "speedup", "matched");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int n = sizes[s];
+        SyntheticProc *prev = malloc(n * sizeof(SyntheticProc));
+        SyntheticProc *curr = malloc(n * sizeof(SyntheticProc));
+        PidIndex index;
+        if (!prev || !curr || pid_index_init(&index, n) != 0) {
+            fprintf(stderr, "Allocation failed\n");
+            return 1;
+        }
+        make_cycle(prev, curr, n);
+
+        // Nested scan is quadratic, keep the repetition count bounded
+        int nested_reps = n >= 100000 ? 1 : (n >= 10000 ? 3 : 100);
+        double t0 = now_sec();
+        long nested = 0;
+        for (int r = 0; r < nested_reps; r++) nested = nested_match(prev, curr, n);
+        double nested_us = (now_sec() - t0) / nested_reps * 1e6;
+
+        int index_reps = 200;
+        for (int i = 0; i < n; i++) pid_index_insert(&index, prev[i].pid, prev[i].starttime, i);
+        t0 = now_sec();
+        long indexed = 0;
+        for (int r = 0; r < index_reps; r++) {
+            // Alternate roles so every repetition is one real cycle:
+            // look up against the indexed list, then re-key on the other
+            if (r % 2 == 0) {
+                indexed = indexed_match(&index, prev, curr, n);
+            } else {
+                indexed_match(&index, curr, prev, n);
+            }
+        }
+        double index_us = (now_sec() - t0) / index_reps * 1e6;
+
+        if (nested != indexed) {
+            fprintf(stderr, "Mismatch: nested matched %ld, index matched %ld\n", nested, indexed);
+            return 1;
+        }
+        printf("%-10d %14.1f %14.1f %9.0fx %10ld\n",
+               n, nested_us, index_us, nested_us / index_us, indexed);
+
+        pid_index_free(&index);
+        free(prev);
+        free(curr);
+    }
+    return 0;
+}
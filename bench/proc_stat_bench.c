@@ -0,0 +1,202 @@
+// Microbenchmark: parsing /proc/[pid]/stat and /proc/[pid]/status.
+// Compares the previous fgets/sscanf-style parsing with the hand-written
+// single-pass parsers in process_monitor.c on recorded file contents, so
+// only parsing cost is measured (no syscalls).
+//
+// Build with `make bench`, run bin/proc_stat_bench.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/process_monitor.h"
+
+// Recorded /proc/[pid]/stat lines, including awkward comm values
+static const char *stat_lines[] = {
+    "1 (systemd) S 0 1 1 0 -1 4194560 22966 1773400 69 224 82 174 5014 718 20 0 1 0 7 28528640 3352 18446744073709551615 1 1 0 0 0 0 671173123 4096 1260 0 0 0 17 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+    "10828 (cat) R 10823 10828 10823 0 -1 4194304 83 0 0 0 0 0 0 0 20 0 1 0 75576 2703360 285 18446744073709551615 93837268062208 93837268082089 140726920455200 0 0 0 0 0 0 0 0 0 17 0 0 0 0 0 0 93837268098096 93837268099712 93837488324608 140726920459588 140726920459608 140726920459608 140726920462315 0\n",
+    "2211 (tmux: server) S 1 2211 2211 0 -1 4194624 9134 0 3 0 4512 2210 0 0 20 0 1 0 3412 12451840 1187 18446744073709551615 94554391441408 94554391999073 140731623212128 0 0 0 0 4096 134302211 0 0 0 17 1 0 0 12 0 0 94554392183280 94554392233572 94554420518912 140731623214811 140731623214816 140731623214816 140731623214060 0\n",
+    "48213 (weird) name) R 48100 48213 48100 34817 48213 4194304 1834115 0 0 0 918273 12345 0 0 20 0 4 0 912345 1073741824 262144 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 3 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+};
+
+// Recorded /proc/[pid]/status contents
+static const char *status_text =
+    "Name:\tpython3\n"
+    "Umask:\t0022\n"
+    "State:\tR (running)\n"
+    "Tgid:\t10879\n"
+    "Ngid:\t0\n"
+    "Pid:\t10879\n"
+    "PPid:\t10852\n"
+    "TracerPid:\t0\n"
+    "Uid:\t0\t0\t0\t0\n"
+    "Gid:\t0\t0\t0\t0\n"
+    "FDSize:\t256\n"
+    "Groups:\t \n"
+    "NStgid:\t10879\n"
+    "NSpid:\t10879\n"
+    "NSpgid:\t10879\n"
+    "NSsid:\t10852\n"
+    "Kthread:\t0\n"
+    "VmPeak:\t   12532 kB\n"
+    "VmSize:\t   12532 kB\n"
+    "VmLck:\t       0 kB\n"
+    "VmPin:\t       0 kB\n"
+    "VmHWM:\t    8764 kB\n"
+    "VmRSS:\t    8764 kB\n"
+    "RssAnon:\t    2924 kB\n"
+    "RssFile:\t    5840 kB\n"
+    "RssShmem:\t       0 kB\n"
+    "VmData:\t    4644 kB\n"
+    "VmStk:\t     132 kB\n"
+    "VmExe:\t       4 kB\n"
+    "VmLib:\t    4280 kB\n"
+    "VmPTE:\t      64 kB\n"
+    "VmSwap:\t       0 kB\n"
+    "HugetlbPages:\t       0 kB\n"
+    "CoreDumping:\t0\n"
+    "THP_enabled:\t1\n"
+    "untag_mask:\t0xffffffffffffffff\n"
+    "Threads:\t1\n"
+    "SigQ:\t1/23960\n"
+    "SigPnd:\t0000000000000000\n"
+    "ShdPnd:\t0000000000000000\n"
+    "SigBlk:\t0000000000000000\n"
+    "SigIgn:\t0000000001001000\n"
+    "SigCgt:\t0000000000000002\n"
+    "CapInh:\t0000000000000000\n"
+    "CapPrm:\t000001fffeffffff\n"
+    "CapEff:\t000001fffeffffff\n"
+    "CapBnd:\t000001fffeffffff\n"
+    "CapAmb:\t0000000000000000\n"
+    "NoNewPrivs:\t0\n"
+    "Seccomp:\t0\n"
+    "Seccomp_filters:\t0\n"
+    "Speculation_Store_Bypass:\tthread vulnerable\n"
+    "SpeculationIndirectBranch:\tconditional enabled\n"
+    "Cpus_allowed:\t1\n"
+    "Cpus_allowed_list:\t0\n"
+    "Mems_allowed:\t00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000000,00000001\n"
+    "Mems_allowed_list:\t0\n"
+    "voluntary_ctxt_switches:\t19\n"
+    "nonvoluntary_ctxt_switches:\t12\n";
+
+// The sscanf-based stat parsing this replaced
+static int legacy_parse_stat(const char *buffer, ProcessInfo *proc) {
+    char state;
+    unsigned long utime, stime;
+    long starttime;
+    char *comm_start = strchr(buffer, '(');
+    char *comm_end = strrchr(buffer, ')');
+
+    if (!comm_start || !comm_end || comm_end <= comm_start) return -1;
+    size_t comm_len = comm_end - comm_start - 1;
+    if (comm_len > MAX_PROC_NAME - 1) comm_len = MAX_PROC_NAME - 1;
+    strncpy(proc->name, comm_start + 1, comm_len);
+    proc->name[comm_len] = '\0';
+
+    sscanf(comm_end + 2, "%c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %*d %*d %ld",
+           &state, &utime, &stime, &starttime);
+    proc->state = state;
+    proc->user_time = utime;
+    proc->system_time = stime;
+    proc->start_time = starttime;
+    return 0;
+}
+
+// The line-by-line strncmp/sscanf status parsing this replaced
+static int legacy_parse_status(const char *buffer, ProcessInfo *proc) {
+    char line[256];
+    const char *p = buffer;
+
+    proc->memory_usage = 0;
+    proc->virtual_memory = 0;
+    proc->uid = 0;
+
+    while (*p) {
+        const char *nl = strchr(p, '\n');
+        size_t len = nl ? (size_t)(nl - p + 1) : strlen(p);
+        if (len >= sizeof(line)) len = sizeof(line) - 1;
+        memcpy(line, p, len);
+        line[len] = '\0';
+        p += nl ? (size_t)(nl - p + 1) : len;
+
+        unsigned long value;
+        if (strncmp(line, "VmRSS:", 6) == 0) {
+            if (sscanf(line, "VmRSS: %lu", &value) == 1) proc->memory_usage = value;
+        } else if (strncmp(line, "VmSize:", 7) == 0) {
+            if (sscanf(line, "VmSize: %lu", &value) == 1) proc->virtual_memory = value;
+        } else if (strncmp(line, "Uid:", 4) == 0) {
+            unsigned int uid;
+            if (sscanf(line, "Uid: %u", &uid) == 1) proc->uid = uid;
+        }
+    }
+    return 0;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void) {
+    const int iterations = 500000;
+    const int nlines = sizeof(stat_lines) / sizeof(stat_lines[0]);
+    size_t lens[sizeof(stat_lines) / sizeof(stat_lines[0])];
+    ProcessInfo a, b;
+    volatile unsigned long sink = 0;
+
+    // Both parsers must agree before timing them
+    for (int i = 0; i < nlines; i++) {
+        lens[i] = strlen(stat_lines[i]);
+        memset(&a, 0, sizeof(a));
+        memset(&b, 0, sizeof(b));
+        legacy_parse_stat(stat_lines[i], &a);
+        parse_proc_stat(stat_lines[i], lens[i], &b);
+        if (strcmp(a.name, b.name) != 0 || a.state != b.state || a.user_time != b.user_time ||
+            a.system_time != b.system_time || a.start_time != b.start_time) {
+            fprintf(stderr, "Parsers disagree on line %d\n", i);
+            return 1;
+        }
+    }
+    legacy_parse_status(status_text, &a);
+    parse_proc_status(status_text, &b);
+    if (a.memory_usage != b.memory_usage || a.virtual_memory != b.virtual_memory || a.uid != b.uid) {
+        fprintf(stderr, "Parsers disagree on status\n");
+        return 1;
+    }
+
+    double t0 = now_sec();
+    for (int i = 0; i < iterations; i++) {
+        legacy_parse_stat(stat_lines[i % nlines], &a);
+        sink += a.user_time;
+    }
+    double legacy_stat = (now_sec() - t0) / iterations * 1e9;
+
+    t0 = now_sec();
+    for (int i = 0; i < iterations; i++) {
+        parse_proc_stat(stat_lines[i % nlines], lens[i % nlines], &b);
+        sink += b.user_time;
+    }
+    double fast_stat = (now_sec() - t0) / iterations * 1e9;
+
+    t0 = now_sec();
+    for (int i = 0; i < iterations; i++) {
+        legacy_parse_status(status_text, &a);
+        sink += a.memory_usage;
+    }
+    double legacy_status = (now_sec() - t0) / iterations * 1e9;
+
+    t0 = now_sec();
+    for (int i = 0; i < iterations; i++) {
+        parse_proc_status(status_text, &b);
+        sink += b.memory_usage;
+    }
+    double fast_status = (now_sec() - t0) / iterations * 1e9;
+
+    printf("%-8s %16s %16s %10s\n", "file", "sscanf ns/parse", "manual ns/parse", "speedup");
+    printf("%-8s %16.1f %16.1f %9.1fx\n", "stat", legacy_stat, fast_stat, legacy_stat / fast_stat);
+    printf("%-8s %16.1f %16.1f %9.1fx\n", "status", legacy_status, fast_status, legacy_status / fast_status);
+    return sink == 0;
+}
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 // Structure to hold CPU statistics
 typedef struct {
@@ -20,9 +21,48 @@ typedef struct {
     unsigned long total_time;  // Total CPU time
 } CPUStats;
 
+// Per-core arrays are processed in blocks of this many cores and padded to
+// a multiple of it, so the delta loops always run over whole blocks
+#define CORE_LANES 8
+
+// Counters kept per core, in /proc/stat column order. guest and guest_nice
+// are already accounted in user and nice.
+typedef enum {
+    CORE_USER,
+    CORE_NICE,
+    CORE_SYSTEM,
+    CORE_IDLE,
+    CORE_IOWAIT,
+    CORE_IRQ,
+    CORE_SOFTIRQ,
+    CORE_STEAL,
+    CORE_FIELD_COUNT
+} CoreField;
+
+// Per-core jiffy counters as a structure of arrays: field f of core i is
+// counters[f * stride + i]. stride is a multiple of CORE_LANES and entries
+// from count up to stride are zero.
+typedef struct {
+    uint64_t *counters;
+    int stride;
+    int count;
+} CoreStats;
+
+// Per-core share of one interval in percent, one array per metric.
+// Each array needs room for the current stride.
+typedef struct {
+    float *busy;     // Everything except idle and iowait
+    float *iowait;
+    float *steal;
+    float *irq;      // Hard and soft interrupts
+} CoreUsage;
+
 // Function declarations
 int read_cpu_stats(CPUStats *stats);
+int read_cpu_core_stats(CPUStats *stats, CoreStats *cores);
 float calculate_cpu_usage(CPUStats *prev, CPUStats *current);
+void calculate_core_usage(const CoreStats *prev, const CoreStats *curr, CoreUsage *usage);
 void print_cpu_info(float usage);
+void print_core_info(const CoreUsage *usage, int count);
 
 #endif // CPU_MONITOR_H 
\ No newline at end of file
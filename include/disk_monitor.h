@@ -7,8 +7,13 @@
 
 #define MAX_DISK_NAME_LEN 32
 
-// Structure to hold disk I/O statistics
+// Structure to hold disk I/O statistics: one line of /proc/diskstats.
+// Times are in milliseconds. The discard fields need Linux 4.18 and the
+// flush fields 5.5; older kernels leave them zero.
 typedef struct {
+    char name[MAX_DISK_NAME_LEN];
+    unsigned int major;
+    unsigned int minor;
     unsigned long reads_completed;
     unsigned long reads_merged;
     unsigned long sectors_read;
@@ -17,11 +22,38 @@ typedef struct {
     unsigned long writes_merged;
     unsigned long sectors_written;
     unsigned long time_writing;
+    unsigned long in_flight;        // I/Os currently in progress (a gauge)
+    unsigned long io_ticks;         // Time the device had I/O in flight
+    unsigned long time_in_queue;    // io_ticks weighted by the number in flight
+    unsigned long discards_completed;
+    unsigned long discards_merged;
+    unsigned long sectors_discarded;
+    unsigned long time_discarding;
+    unsigned long flushes_completed;
+    unsigned long time_flushing;
 } DiskStats;
 
+// Per-device rates derived from two samples
+typedef struct {
+    char name[MAX_DISK_NAME_LEN];
+    float read_iops;
+    float write_iops;
+    float discard_iops;
+    float read_mb_s;
+    float write_mb_s;
+    float await_ms;        // Average time per completed request, queueing included
+    float queue_depth;     // Average number of requests in flight (aqu-sz)
+    float util_percent;    // Share of the interval the device was busy
+    unsigned long in_flight;
+} DiskRates;
+
 // Function declarations
 int read_disk_stats(const char *device, DiskStats *stats);
+int read_all_disk_stats(DiskStats *devices, int max_devices, const char *pattern);
 void calculate_disk_usage(DiskStats *prev, DiskStats *current, float *read_speed, float *write_speed);
+int calculate_disk_rates(const DiskStats *prev, int prev_count, const DiskStats *curr, int curr_count,
+                         float elapsed_sec, DiskRates *rates);
 void print_disk_info(float read_speed, float write_speed);
+void print_disk_rates(const DiskRates *rates, int count);
 
-#endif // DISK_MONITOR_H 
\ No newline at end of file
+#endif // DISK_MONITOR_H
@@ -25,6 +25,14 @@ typedef struct {
     size_t size;
 } docker_api_response_t;
 
+// Defaults for the stats request pool
+#define DOCKER_DEFAULT_CONCURRENCY 16
+#define DOCKER_DEFAULT_TIMEOUT_MS 5000
+
+// Set how many stats requests run at once and the timeout of each one.
+// Takes effect at the next init_docker_monitor.
+void set_docker_request_limits(int concurrency, long timeout_ms);
+
 // Initialize Docker monitoring
 int init_docker_monitor(void);
 
@@ -3,19 +3,26 @@
 
 #include <stdbool.h>
 #include "disk_monitor.h"
+#include "process_rank.h"
 
 #define MAX_DISK_NAME_LEN 32
 
 // Monitoring configuration
 typedef struct {
     bool monitor_cpu;
+    bool show_cores;      // Per-core breakdown under the CPU total
     bool monitor_memory;
     bool monitor_disk;
     bool monitor_processes;
     bool monitor_docker;    // New field for Docker monitoring
     int num_processes;    // Number of top processes to show
-    char disk_device[MAX_DISK_NAME_LEN];
+    ProcessSortKey sort_key;  // Ranking used for the process list
+    char disk_filter[MAX_DISK_NAME_LEN];  // Glob on device names; empty = all
     int update_interval;
+    int scan_workers;     // Threads used to scan /proc (1 = no threading)
+    bool proc_events;     // Track processes via the netlink proc connector
+    int docker_concurrency;   // Container stats requests in flight at once
+    int docker_timeout_ms;    // Timeout of one container stats request
 } MonitorConfig;
 
 // Function declarations
@@ -0,0 +1,39 @@
+#ifndef PID_INDEX_H
+#define PID_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// Open-addressing hash table mapping (pid, starttime) to a slot in a
+// process array. Keying on starttime as well keeps a reused PID from being
+// matched against the process that previously owned it.
+//
+// The table is meant to live across collection cycles: pid_index_clear is
+// O(1) (it bumps an epoch instead of wiping the entries), and storage is
+// only reallocated when the process count outgrows it.
+
+typedef struct {
+    pid_t pid;
+    uint32_t epoch;           // Entry is live only if it matches the table epoch
+    unsigned long starttime;
+    int slot;
+} PidIndexEntry;
+
+typedef struct {
+    PidIndexEntry *entries;
+    size_t capacity;          // Always a power of two
+    size_t count;
+    uint32_t epoch;
+} PidIndex;
+
+// Function declarations
+int pid_index_init(PidIndex *index, size_t expected);
+void pid_index_free(PidIndex *index);
+void pid_index_clear(PidIndex *index);
+int pid_index_reserve(PidIndex *index, size_t expected);
+int pid_index_insert(PidIndex *index, pid_t pid, unsigned long starttime, int slot);
+int pid_index_lookup(const PidIndex *index, pid_t pid, unsigned long starttime);
+int pid_index_remove(PidIndex *index, pid_t pid, unsigned long starttime);
+
+#endif // PID_INDEX_H
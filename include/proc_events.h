@@ -0,0 +1,21 @@
+#ifndef PROC_EVENTS_H
+#define PROC_EVENTS_H
+
+#include "process_monitor.h"
+
+// Process lifecycle activity seen between two samples
+typedef struct {
+    unsigned long forks;        // New processes (threads are not counted)
+    unsigned long execs;
+    unsigned long exits;
+    unsigned long short_lived;  // Started and exited before being sampled
+    unsigned long resyncs;      // Full rescans forced by lost events
+} ProcEventCounts;
+
+// Function declarations
+int proc_events_open(void);
+void proc_events_close(void);
+int proc_events_get_process_list(ProcessInfo **processes, int *count, int max_processes,
+                                 ProcEventCounts *counts);
+
+#endif // PROC_EVENTS_H
@@ -9,7 +9,11 @@
 #include <ctype.h>
 #include <pwd.h>
 #include <time.h>
+#include <stdint.h>
+#include <fcntl.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 
 // Process state descriptions
 #define PROC_RUNNING     'R'
@@ -22,6 +26,9 @@
 // Maximum process name length
 #define MAX_PROC_NAME 256
 
+// Longest comm the kernel reports in /proc/[pid]/stat (kernel threads)
+#define PROC_COMM_MAX 64
+
 // CPU usage thresholds for color coding
 #define CPU_HIGH_THRESHOLD 80.0
 #define CPU_MED_THRESHOLD  50.0
@@ -53,15 +60,24 @@ typedef struct {
     unsigned long start_time;     // Process start time
     uid_t uid;                   // User ID
     unsigned long virtual_memory; // Virtual memory size
+    unsigned long minor_faults;   // Cumulative minor page faults
+    unsigned long major_faults;   // Cumulative major page faults
+    unsigned long blkio_ticks;    // Cumulative block I/O delay (clock ticks)
+    float fault_rate;             // Page faults per second
+    float io_delay;               // % of time spent waiting on block I/O
 } ProcessInfo;
 
 // Function declarations
+int parse_proc_stat(const char *buf, size_t len, ProcessInfo *proc);
+int parse_proc_status(const char *buf, ProcessInfo *proc);
 int read_proc_stat(pid_t pid, ProcessInfo *proc);
 int read_proc_status(pid_t pid, ProcessInfo *proc);
 int read_proc_cmdline(pid_t pid, ProcessInfo *proc);
 void calculate_proc_cpu_usage(ProcessInfo *prev, ProcessInfo *current, unsigned long total_time);
+void calculate_proc_rates(ProcessInfo *prev, ProcessInfo *current, double elapsed_sec);
 int compare_processes(const void *a, const void *b);
 int get_process_list(ProcessInfo **processes, int *count, int max_processes);
+unsigned long process_scan_syscalls(void);
 void print_process_header(void);
 void print_process_info(ProcessInfo *proc);
 void print_process_list(ProcessInfo *processes, int count);
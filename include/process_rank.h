@@ -0,0 +1,25 @@
+#ifndef PROCESS_RANK_H
+#define PROCESS_RANK_H
+
+#include "process_monitor.h"
+
+// Most processes a published ranking holds per sort key
+#define MAX_TOP_PROCESSES 64
+
+// Keys the collector ranks processes by
+typedef enum {
+    SORT_CPU,       // cpu_usage
+    SORT_RSS,       // memory_usage
+    SORT_VIRT,      // virtual_memory
+    SORT_IO,        // io_delay
+    SORT_FAULTS,    // fault_rate
+    SORT_KEY_COUNT
+} ProcessSortKey;
+
+// Function declarations
+int rank_top_processes(const ProcessInfo *processes, int count, ProcessSortKey key,
+                       int *top, int k);
+const char *sort_key_name(ProcessSortKey key);
+int parse_sort_key(const char *name, ProcessSortKey *key);
+
+#endif // PROCESS_RANK_H
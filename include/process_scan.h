@@ -0,0 +1,33 @@
+#ifndef PROCESS_SCAN_H
+#define PROCESS_SCAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "process_monitor.h"
+
+// Upper bound for the --workers option
+#define MAX_SCAN_WORKERS 64
+
+// What one scan worker did during the last get_process_list call
+typedef struct {
+    uint64_t elapsed_ns;      // Wall time spent scanning
+    int processes;            // /proc entries this worker read
+    int stolen;               // ...of which were taken from another shard
+    unsigned long syscalls;   // Syscalls this worker issued
+} ScanWorkerStats;
+
+// A known PID to refresh without listing /proc
+typedef struct {
+    pid_t pid;
+    uid_t uid;                // Cached owner, used when known_owner is set
+    bool known_owner;         // Skip the fstat and reuse uid
+} TrackedPid;
+
+// Function declarations
+int get_process_list_for(const TrackedPid *pids, int npids,
+                         ProcessInfo **processes, int *count, int max_processes);
+int set_process_scan_workers(int workers);
+int get_process_scan_stats(ScanWorkerStats *stats, int max_workers);
+void shutdown_process_scan(void);
+
+#endif // PROCESS_SCAN_H
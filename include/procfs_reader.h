@@ -0,0 +1,29 @@
+#ifndef PROCFS_READER_H
+#define PROCFS_READER_H
+
+#include <stddef.h>
+
+// A procfs/sysfs file that is opened once and re-read with pread() at
+// offset 0 on every sample. The kernel regenerates the contents on each
+// read, so a steady-state sample costs a single syscall and no allocation:
+// the buffer is kept and only grows if the file outgrows it.
+typedef struct {
+    const char *path;
+    int fd;
+    char *buf;
+    size_t cap;
+    size_t len;
+} ProcFile;
+
+#define PROCFS_FILE_INIT(file_path) { (file_path), -1, NULL, 0, 0 }
+
+// Function declarations
+const char *procfs_read(ProcFile *file);
+void procfs_close(ProcFile *file);
+
+// Parsing helpers for the NUL-terminated buffers returned above
+unsigned long procfs_next_ulong(const char **cursor);
+const char *procfs_skip_field(const char *p);
+const char *procfs_next_line(const char *p);
+
+#endif // PROCFS_READER_H
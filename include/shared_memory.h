@@ -4,40 +4,149 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
-#include <semaphore.h>
 
 #include "monitor.h"
 #include "docker_monitor.h"
+#include "proc_events.h"
+#include "process_rank.h"
 
 // Shared memory segment name
 #define SHM_NAME "/system_monitor_shm"
-#define SEM_NAME "/system_monitor_sem"
-#define MAX_DOCKER_CONTAINERS 100
 
-// Structure to hold all monitoring data in shared memory
+// Segment identification. SHM_VERSION changes whenever the layout of
+// ShmHeader or Snapshot changes, so old readers refuse a new collector.
+#define SHM_MAGIC 0x4e4f4d53  // "SMON"
+#define SHM_VERSION 4
+
+// Table capacities of a fresh segment; the collector grows them on demand.
+// The core table starts at the number of configured CPUs.
+#define SHM_INITIAL_PROCESSES 1024
+#define SHM_INITIAL_CONTAINERS 16
+#define SHM_INITIAL_DISKS 32
+
+// Number of snapshot buffers. With three slots the collector always has a
+// back buffer to fill while readers copy the latest one, and a reader that
+// is a full cycle late still finds its slot intact.
+#define SNAPSHOT_SLOTS 3
+
+// When each subsystem was last sampled (CLOCK_MONOTONIC, nanoseconds).
+// Zero means the subsystem was not sampled for this snapshot.
+typedef struct {
+    uint64_t cpu;
+    uint64_t memory;
+    uint64_t disk;
+    uint64_t processes;
+    uint64_t docker;
+} SampleTimes;
+
+// Where the variable-size tables of a slot live. Offsets are in bytes from
+// the start of the Snapshot, so a private copy made by read_snapshot stays
+// self-describing.
 typedef struct {
+    uint64_t processes_offset;
+    uint64_t docker_offset;
+    uint64_t cores_offset;
+    uint64_t disks_offset;
+    uint32_t process_capacity;
+    uint32_t docker_capacity;
+    uint32_t core_capacity;   // Stride of the per-core arrays (see CoreStats)
+    uint32_t disk_capacity;
+} SnapshotLayout;
+
+// One complete, self-consistent set of monitoring data. The process,
+// container, per-core and disk tables follow the fixed part; use
+// snapshot_processes(), snapshot_docker_stats(), snapshot_cores() and
+// snapshot_disks().
+typedef struct {
+    uint64_t generation;      // Generation this snapshot was published as
+    uint64_t wall_time_ns;    // CLOCK_REALTIME at publication
+    SampleTimes sampled_at;
     CPUStats cpu_stats;
+    int core_count;
     MemoryStats memory_stats;
-    DiskStats disk_stats;
-    ProcessInfo processes[MAX_PROCESSES];
+    int disk_count;
     int process_count;
-    docker_stats_t docker_stats[MAX_DOCKER_CONTAINERS];
+    unsigned long scan_syscalls;   // Syscalls spent on the process scan
+    ProcEventCounts proc_events;   // Lifecycle activity (with --proc-events)
+    // Top processes per sort key, as indices into the process table, best
+    // first. Ranked once by the collector so readers never sort the table.
+    int top[SORT_KEY_COUNT][MAX_TOP_PROCESSES];
+    int top_count[SORT_KEY_COUNT];
     int docker_count;
-    bool data_ready;
+    SnapshotLayout layout;
+} Snapshot;
+
+// Snapshot buffer guarded by a sequence counter (odd while being written).
+// Slots are slot_size bytes apart; the tables live in the space after data.
+typedef struct {
+    _Atomic uint64_t seq;
+    Snapshot data;
+} SnapshotSlot;
+
+// Header at offset 0 of the segment. Everything a reader needs to find
+// the slots is here; the rest of the segment is SNAPSHOT_SLOTS slots.
+typedef struct {
+    uint32_t magic;                // SHM_MAGIC once the header is initialized
+    uint32_t version;              // SHM_VERSION of the collector
+    _Atomic uint64_t size;         // Segment size in bytes; only ever grows
+    _Atomic uint64_t layout_seq;   // Odd while the collector resizes the slots
+    _Atomic uint64_t generation;   // Last published generation (0 = none yet)
+    _Atomic uint32_t latest;       // Slot holding the last published snapshot
+    _Atomic uint32_t wake_seq;     // Futex word bumped on every publication
+    uint64_t slot_offset;          // Offset of the first slot
+    uint64_t slot_size;            // Distance between slots
+    SnapshotLayout layout;         // Table layout shared by every slot
+} ShmHeader;
+
+// Process-local handle on the segment
+typedef struct {
+    int fd;
+    ShmHeader *header;   // Mapping of the whole segment
+    size_t mapped_size;  // Bytes mapped; less than header->size after a resize
+    Snapshot *copy;      // Reader's private copy, see read_snapshot
+    size_t copy_size;
 } SharedData;
 
 // Function declarations
 SharedData* create_shared_memory(void);
 SharedData* attach_shared_memory(void);
 void destroy_shared_memory(SharedData *data);
-sem_t* create_semaphore(void);
-sem_t* open_semaphore(void);
-void close_semaphore(sem_t *sem);
-void destroy_semaphore(void);
 
-#endif // SHARED_MEMORY_H 
\ No newline at end of file
+// Writer side: fill the returned back buffer, then publish it
+Snapshot* begin_snapshot(SharedData *data);
+void publish_snapshot(SharedData *data, Snapshot *snap);
+
+// Grow the tables so *snap can hold at least the capacities set in need
+// (offsets are ignored, zero capacities leave a table alone). The segment
+// may move, so *snap is updated. Returns -1 if the segment could not be
+// grown; the old capacities remain usable.
+int reserve_snapshot(SharedData *data, Snapshot **snap, const SnapshotLayout *need);
+
+// Reader side: copy the latest published snapshot without blocking the
+// writer. Returns a private copy that stays valid until the next call, or
+// NULL if nothing has been published yet.
+Snapshot* read_snapshot(SharedData *data);
+uint64_t snapshot_generation(SharedData *data);
+
+// Sleep until a generation newer than last_generation is published.
+// Returns 1 when one is available, 0 on timeout or signal, -1 on error.
+// A negative timeout_ms waits indefinitely.
+int wait_for_snapshot(SharedData *data, uint64_t last_generation, int timeout_ms);
+
+// Tables that follow a snapshot
+ProcessInfo* snapshot_processes(const Snapshot *snap);
+docker_stats_t* snapshot_docker_stats(const Snapshot *snap);
+void snapshot_cores(const Snapshot *snap, CoreStats *cores);
+DiskStats* snapshot_disks(const Snapshot *snap);
+
+// Timestamp helper for SampleTimes
+uint64_t monotonic_ns(void);
+
+#endif // SHARED_MEMORY_H
@@ -1,5 +1,9 @@
 #include "../include/monitor.h"
 #include "../include/shared_memory.h"
+#include "../include/pid_index.h"
+#include "../include/process_scan.h"
+#include "../include/proc_events.h"
+#include "../include/process_rank.h"
 
 static volatile sig_atomic_t running = 1;
 
@@ -12,11 +16,11 @@ void signal_handler(int signum) {
 int main(int argc, char *argv[]) {
     MonitorConfig config;
     SharedData *shared_data = NULL;
-    sem_t *sem = NULL;
+    Snapshot *snap = NULL;
     CPUStats prev_cpu_stats;
-    DiskStats prev_disk_stats;
     ProcessInfo *prev_processes = NULL;
-    ProcessInfo *current_processes = NULL;
+    uint64_t prev_process_time = 0;
+    PidIndex prev_index;
     docker_stats_t *docker_stats = NULL;
     int process_count = 0;
 
@@ -30,9 +34,15 @@ int main(int argc, char *argv[]) {
 
     printf("Debug: Arguments parsed successfully\n");
 
+    // (pid, starttime) -> slot in prev_processes, kept across cycles
+    if (pid_index_init(&prev_index, SHM_INITIAL_PROCESSES) != 0) {
+        return 1;
+    }
+
     // Initialize Docker monitoring if enabled
     if (config.monitor_docker) {
         printf("Debug: Initializing Docker monitoring...\n");
+        set_docker_request_limits(config.docker_concurrency, config.docker_timeout_ms);
         if (init_docker_monitor() != 0) {
             fprintf(stderr, "Warning: Failed to initialize Docker monitoring\n");
             config.monitor_docker = false;  // Disable Docker monitoring on error
@@ -54,16 +64,6 @@ int main(int argc, char *argv[]) {
     }
     printf("Collector process: Successfully created shared memory\n");
 
-    printf("Collector process: Creating semaphore...\n");
-    // Create semaphore
-    sem = create_semaphore();
-    if (!sem) {
-        fprintf(stderr, "Failed to create semaphore\n");
-        destroy_shared_memory(shared_data);
-        return 1;
-    }
-    printf("Collector process: Successfully created semaphore\n");
-
     // Initial readings
     printf("Debug: Taking initial readings...\n");
     if (config.monitor_cpu) {
@@ -73,16 +73,35 @@ int main(int argc, char *argv[]) {
         }
     }
     if (config.monitor_disk) {
-        printf("Debug: Reading initial disk stats for device %s...\n", config.disk_device);
-        if (read_disk_stats(config.disk_device, &prev_disk_stats) != 0) {
+        printf("Debug: Reading initial disk stats (devices: %s)...\n",
+               config.disk_filter[0] ? config.disk_filter : "all");
+        if (read_all_disk_stats(NULL, 0, config.disk_filter) < 0) {
             fprintf(stderr, "Failed to read initial disk stats\n");
         }
     }
     if (config.monitor_processes) {
+        if (config.scan_workers > 1) {
+            printf("Debug: Starting %d process scan workers...\n", config.scan_workers);
+            if (set_process_scan_workers(config.scan_workers) != 0) {
+                fprintf(stderr, "Warning: Scanning with fewer workers than requested\n");
+            }
+        }
+        if (config.proc_events) {
+            if (proc_events_open() != 0) {
+                fprintf(stderr, "Warning: Process events unavailable, using full /proc scans\n");
+                config.proc_events = false;
+            } else {
+                printf("Debug: Subscribed to process events\n");
+            }
+        }
         printf("Debug: Reading initial process list...\n");
         if (get_process_list(&prev_processes, &process_count, MAX_PROCESSES) != 0) {
             fprintf(stderr, "Failed to read initial process list\n");
         }
+        prev_process_time = monotonic_ns();
+        for (int i = 0; i < process_count; i++) {
+            pid_index_insert(&prev_index, prev_processes[i].pid, prev_processes[i].start_time, i);
+        }
     }
     printf("Debug: Initial readings complete\n");
 
@@ -90,32 +109,56 @@ int main(int argc, char *argv[]) {
 
     // Main collection loop
     while (running) {
-        printf("Collector process: Waiting for semaphore...\n");
-        // Wait for semaphore
-        sem_wait(sem);
-        printf("Collector process: Got semaphore\n");
+        // Fill the back buffer; readers keep seeing the previous snapshot
+        // until it is published, so nothing here needs a lock.
+        snap = begin_snapshot(shared_data);
 
         // Collect CPU stats
         if (config.monitor_cpu) {
             printf("Debug: Collecting CPU stats...\n");
-            if (read_cpu_stats(&shared_data->cpu_stats) != 0) {
+            CoreStats cores;
+            snapshot_cores(snap, &cores);
+            int found = read_cpu_core_stats(&snap->cpu_stats, &cores);
+            SnapshotLayout need = { .core_capacity = (uint32_t)found };
+            if (found > cores.stride && reserve_snapshot(shared_data, &snap, &need) == 0) {
+                // CPUs were brought online beyond the core table: read again
+                snapshot_cores(snap, &cores);
+                found = read_cpu_core_stats(&snap->cpu_stats, &cores);
+            }
+            if (found < 0) {
                 fprintf(stderr, "Failed to read CPU stats\n");
+            } else {
+                snap->core_count = cores.count;
+                snap->sampled_at.cpu = monotonic_ns();
             }
         }
 
         // Collect memory stats
         if (config.monitor_memory) {
             printf("Debug: Collecting memory stats...\n");
-            if (read_memory_stats(&shared_data->memory_stats) != 0) {
+            if (read_memory_stats(&snap->memory_stats) != 0) {
                 fprintf(stderr, "Failed to read memory stats\n");
+            } else {
+                snap->sampled_at.memory = monotonic_ns();
             }
         }
 
         // Collect disk stats
         if (config.monitor_disk) {
             printf("Debug: Collecting disk stats...\n");
-            if (read_disk_stats(config.disk_device, &shared_data->disk_stats) != 0) {
+            int capacity = (int)snap->layout.disk_capacity;
+            int found = read_all_disk_stats(snapshot_disks(snap), capacity, config.disk_filter);
+            SnapshotLayout need = { .disk_capacity = (uint32_t)found };
+            if (found > capacity && reserve_snapshot(shared_data, &snap, &need) == 0) {
+                // More devices than the table holds: read again into the larger one
+                capacity = (int)snap->layout.disk_capacity;
+                found = read_all_disk_stats(snapshot_disks(snap), capacity, config.disk_filter);
+            }
+            if (found < 0) {
                 fprintf(stderr, "Failed to read disk stats\n");
+            } else {
+                snap->disk_count = found < capacity ? found : capacity;
+                snap->sampled_at.disk = monotonic_ns();
             }
         }
 
@@ -124,26 +167,71 @@ int main(int argc, char *argv[]) {
             printf("Debug: Collecting process stats...\n");
             int new_count = 0;
             ProcessInfo *new_processes = NULL;
-            if (get_process_list(&new_processes, &new_count, MAX_PROCESSES) == 0) {
-                // Calculate CPU usage for processes
+            int scanned;
+            if (config.proc_events) {
+                // Refresh only live PIDs; rescans by itself if events were lost
+                scanned = proc_events_get_process_list(&new_processes, &new_count, MAX_PROCESSES,
+                                                       &snap->proc_events);
+            } else {
+                scanned = get_process_list(&new_processes, &new_count, MAX_PROCESSES);
+            }
+            if (scanned == 0) {
+                uint64_t process_time = monotonic_ns();
+                double elapsed = (process_time - prev_process_time) / 1e9;
+
+                // Calculate CPU usage and rates for processes seen last cycle
                 for (int i = 0; i < new_count; i++) {
-                    for (int j = 0; j < process_count; j++) {
-                        if (new_processes[i].pid == prev_processes[j].pid) {
-                            calculate_proc_cpu_usage(&prev_processes[j], 
-                                                  &new_processes[i],
-                                                  shared_data->cpu_stats.user + 
-                                                  shared_data->cpu_stats.system - 
-                                                  prev_cpu_stats.user - 
-                                                  prev_cpu_stats.system);
-                            break;
-                        }
+                    int j = pid_index_lookup(&prev_index, new_processes[i].pid,
+                                             new_processes[i].start_time);
+                    if (j >= 0) {
+                        calculate_proc_cpu_usage(&prev_processes[j], 
+                                              &new_processes[i],
+                                              snap->cpu_stats.user + 
+                                              snap->cpu_stats.system - 
+                                              prev_cpu_stats.user - 
+                                              prev_cpu_stats.system);
+                        calculate_proc_rates(&prev_processes[j], &new_processes[i], elapsed);
                     }
                 }
 
-                // Copy to shared memory
-                shared_data->process_count = new_count > MAX_PROCESSES ? MAX_PROCESSES : new_count;
-                memcpy(shared_data->processes, new_processes, 
-                       shared_data->process_count * sizeof(ProcessInfo));
+                // Copy to shared memory, growing the segment if the host
+                // has more processes than it was sized for
+                SnapshotLayout need = { .process_capacity = (uint32_t)new_count };
+                if (reserve_snapshot(shared_data, &snap, &need) != 0) {
+                    fprintf(stderr, "Warning: Publishing only %u of %d processes\n",
+                            snap->layout.process_capacity, new_count);
+                }
+                snap->process_count = new_count > (int)snap->layout.process_capacity ?
+                                      (int)snap->layout.process_capacity : new_count;
+                memcpy(snapshot_processes(snap), new_processes, 
+                       snap->process_count * sizeof(ProcessInfo));
+                snap->sampled_at.processes = process_time;
+
+                // Rank once per key so every reader can pick its own order
+                for (int key = 0; key < SORT_KEY_COUNT; key++) {
+                    snap->top_count[key] = rank_top_processes(snapshot_processes(snap),
+                                                              snap->process_count,
+                                                              (ProcessSortKey)key, snap->top[key],
+                                                              MAX_TOP_PROCESSES);
+                }
+                snap->scan_syscalls = process_scan_syscalls();
+                printf("Debug: Process scan: %d processes, %lu syscalls (%.1f per process)\n",
+                       new_count, snap->scan_syscalls,
+                       new_count > 0 ? (double)snap->scan_syscalls / new_count : 0.0);
+                if (config.proc_events) {
+                    printf("Debug: Process events: %lu forks, %lu execs, %lu exits, %lu short-lived\n",
+                           snap->proc_events.forks, snap->proc_events.execs,
+                           snap->proc_events.exits, snap->proc_events.short_lived);
+                }
+                if (config.scan_workers > 1) {
+                    ScanWorkerStats worker_stats[MAX_SCAN_WORKERS];
+                    int workers = get_process_scan_stats(worker_stats, MAX_SCAN_WORKERS);
+                    for (int w = 0; w < workers; w++) {
+                        printf("Debug:   worker %d: %d processes (%d stolen) in %.3f ms\n",
+                               w, worker_stats[w].processes, worker_stats[w].stolen,
+                               worker_stats[w].elapsed_ns / 1e6);
+                    }
+                }
 
                 // Update previous process states
                 if (prev_processes) {
@@ -151,6 +239,13 @@ int main(int argc, char *argv[]) {
                 }
                 prev_processes = new_processes;
                 process_count = new_count;
+                prev_process_time = process_time;
+
+                // Re-key the index on the new list for the next cycle
+                pid_index_clear(&prev_index);
+                for (int i = 0; i < process_count; i++) {
+                    pid_index_insert(&prev_index, prev_processes[i].pid, prev_processes[i].start_time, i);
+                }
             } else {
                 fprintf(stderr, "Failed to get process list\n");
                 if (new_processes) {
@@ -162,40 +257,39 @@ int main(int argc, char *argv[]) {
         // Collect Docker stats
         if (config.monitor_docker) {
             printf("Debug: Collecting Docker stats...\n");
-            if (get_docker_stats(&docker_stats, &shared_data->docker_count) == 0) {
-                printf("Debug: Got Docker stats for %d containers\n", shared_data->docker_count);
+            int count = 0;
+            if (get_docker_stats(&docker_stats, &count) == 0) {
+                printf("Debug: Got Docker stats for %d containers\n", count);
                 // Copy stats to shared memory
-                int count = shared_data->docker_count;
-                if (count > MAX_DOCKER_CONTAINERS) {
-                    count = MAX_DOCKER_CONTAINERS;
+                SnapshotLayout need = { .docker_capacity = (uint32_t)count };
+                if (reserve_snapshot(shared_data, &snap, &need) != 0 &&
+                    count > (int)snap->layout.docker_capacity) {
+                    fprintf(stderr, "Warning: Publishing only %u of %d containers\n",
+                            snap->layout.docker_capacity, count);
+                    count = (int)snap->layout.docker_capacity;
                 }
-                memcpy(shared_data->docker_stats, docker_stats, 
+                memcpy(snapshot_docker_stats(snap), docker_stats, 
                        count * sizeof(docker_stats_t));
+                snap->docker_count = count;
+                snap->sampled_at.docker = monotonic_ns();
                 
                 // Free temporary stats
                 free_docker_stats(docker_stats);
                 docker_stats = NULL;
             } else {
                 fprintf(stderr, "Failed to get Docker stats\n");
-                shared_data->docker_count = 0;
             }
         }
 
         // Update previous stats
         if (config.monitor_cpu) {
-            prev_cpu_stats = shared_data->cpu_stats;
-        }
-        if (config.monitor_disk) {
-            prev_disk_stats = shared_data->disk_stats;
+            prev_cpu_stats = snap->cpu_stats;
         }
 
-        // Mark data as ready
-        shared_data->data_ready = true;
-        printf("Collector process: Data is ready\n");
-
-        // Release semaphore
-        sem_post(sem);
-        printf("Collector process: Released semaphore\n");
+        // Publish the snapshot
+        publish_snapshot(shared_data, snap);
+        printf("Collector process: Published generation %lu\n",
+               (unsigned long)snap->generation);
 
         // Sleep for update interval
         printf("Debug: Sleeping for %d seconds...\n", config.update_interval);
@@ -208,15 +302,20 @@ int main(int argc, char *argv[]) {
         cleanup_docker_monitor();
     }
 
+    if (config.monitor_processes) {
+        if (config.proc_events) {
+            proc_events_close();
+        }
+        shutdown_process_scan();
+    }
     if (prev_processes) {
         free(prev_processes);
     }
+    pid_index_free(&prev_index);
     if (docker_stats) {
         free_docker_stats(docker_stats);
     }
     destroy_shared_memory(shared_data);
-    close_semaphore(sem);
-    destroy_semaphore();
 
     printf("\nData collector terminated\n");
     return 0;
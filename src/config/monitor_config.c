@@ -8,43 +8,67 @@ void print_usage(const char *program_name) {
     printf("Options:\n");
     printf("  -h, --help              Display this help message\n");
     printf("  -c, --cpu               Monitor CPU usage\n");
+    printf("  -C, --cores             Show usage per CPU core (implies --cpu)\n");
     printf("  -m, --memory            Monitor memory usage\n");
-    printf("  -d, --disk DEVICE       Monitor disk I/O for specified device (e.g., sda, nvme0n1)\n");
+    printf("  -d, --disk GLOB         Monitor disk I/O for devices matching GLOB (e.g., sda, 'nvme*')\n");
     printf("  -p, --processes N       Show top N processes (default: 10)\n");
+    printf("  -s, --sort KEY          Rank processes by cpu, rss, virt, io or faults (default: cpu)\n");
     printf("  -D, --docker            Monitor Docker containers\n");
     printf("  -i, --interval N        Update interval in seconds (default: 2)\n");
+    printf("  -w, --workers N         Threads used to scan /proc (default: 1)\n");
+    printf("  -e, --proc-events       Track processes with fork/exec/exit events (needs CAP_NET_ADMIN)\n");
+    printf("      --docker-concurrency N  Container stats requests in flight at once (default: 16)\n");
+    printf("      --docker-timeout MS     Timeout of one container stats request (default: 5000)\n");
     printf("  -a, --all              Monitor all metrics (CPU, memory, disk, processes, docker)\n");
-    printf("\nExample: %s -a -p 10 -d nvme0n1\n", program_name);
+    printf("\nExample: %s -a -p 10 -d 'nvme*'\n", program_name);
 }
 
+// Long-only options
+enum {
+    OPT_DOCKER_CONCURRENCY = 256,
+    OPT_DOCKER_TIMEOUT,
+};
+
 // Parse command line arguments
 int parse_arguments(int argc, char *argv[], MonitorConfig *config) {
     static struct option long_options[] = {
         {"help",      no_argument,       0, 'h'},
         {"cpu",       no_argument,       0, 'c'},
+        {"cores",     no_argument,       0, 'C'},
         {"memory",    no_argument,       0, 'm'},
         {"disk",      required_argument, 0, 'd'},
         {"processes", optional_argument, 0, 'p'},
+        {"sort",      required_argument, 0, 's'},
         {"docker",    no_argument,       0, 'D'},
         {"interval",  required_argument, 0, 'i'},
+        {"workers",   required_argument, 0, 'w'},
+        {"proc-events", no_argument,     0, 'e'},
+        {"docker-concurrency", required_argument, 0, OPT_DOCKER_CONCURRENCY},
+        {"docker-timeout",     required_argument, 0, OPT_DOCKER_TIMEOUT},
         {"all",       no_argument,       0, 'a'},
         {0, 0, 0, 0}
     };
 
     // Set default values
     config->monitor_cpu = false;
+    config->show_cores = false;
     config->monitor_memory = false;
     config->monitor_disk = false;
     config->monitor_processes = false;
     config->monitor_docker = false;
     config->num_processes = 10;  // Default number of processes to show
+    config->sort_key = SORT_CPU;
     config->update_interval = 2;  // Default update interval in seconds
-    strncpy(config->disk_device, "sda", MAX_DISK_NAME_LEN - 1);
+    config->scan_workers = 1;     // Scan /proc on the collector thread
+    config->proc_events = false;
+    config->docker_concurrency = DOCKER_DEFAULT_CONCURRENCY;
+    config->docker_timeout_ms = DOCKER_DEFAULT_TIMEOUT_MS;
+    config->disk_filter[0] = '\0';  // Every device in /proc/diskstats
 
     int option_index = 0;
     int c;
 
-    while ((c = getopt_long(argc, argv, "hcmd:p::Di:a", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hcCmd:p::s:Di:w:ea", long_options, &option_index)) != -1) {
         switch (c) {
             case 'h':
                 print_usage(argv[0]);
@@ -52,13 +76,18 @@ int parse_arguments(int argc, char *argv[], MonitorConfig *config) {
             case 'c':
                 config->monitor_cpu = true;
                 break;
+            case 'C':
+                config->monitor_cpu = true;
+                config->show_cores = true;
+                break;
             case 'm':
                 config->monitor_memory = true;
                 break;
             case 'd':
                 config->monitor_disk = true;
                 if (optarg) {
-                    strncpy(config->disk_device, optarg, MAX_DISK_NAME_LEN - 1);
+                    strncpy(config->disk_filter, optarg, sizeof(config->disk_filter) - 1);
+                    config->disk_filter[sizeof(config->disk_filter) - 1] = '\0';
                 }
                 break;
             case 'p':
@@ -70,6 +99,12 @@ int parse_arguments(int argc, char *argv[], MonitorConfig *config) {
                     }
                 }
                 break;
+            case 's':
+                if (parse_sort_key(optarg, &config->sort_key) != 0) {
+                    fprintf(stderr, "Unknown sort key '%s' (use cpu, rss, virt, io or faults)\n", optarg);
+                    return 1;
+                }
+                break;
             case 'D':
                 config->monitor_docker = true;
                 break;
@@ -81,6 +116,27 @@ int parse_arguments(int argc, char *argv[], MonitorConfig *config) {
                     }
                 }
                 break;
+            case 'w':
+                config->scan_workers = atoi(optarg);
+                if (config->scan_workers <= 0) {
+                    config->scan_workers = 1;
+                }
+                break;
+            case 'e':
+                config->proc_events = true;
+                break;
+            case OPT_DOCKER_CONCURRENCY:
+                config->docker_concurrency = atoi(optarg);
+                if (config->docker_concurrency <= 0) {
+                    config->docker_concurrency = DOCKER_DEFAULT_CONCURRENCY;
+                }
+                break;
+            case OPT_DOCKER_TIMEOUT:
+                config->docker_timeout_ms = atoi(optarg);
+                if (config->docker_timeout_ms <= 0) {
+                    config->docker_timeout_ms = DOCKER_DEFAULT_TIMEOUT_MS;
+                }
+                break;
             case 'a':
                 config->monitor_cpu = true;
                 config->monitor_memory = true;
@@ -1,36 +1,67 @@
 #include "../../include/cpu_monitor.h"
+#include "../../include/procfs_reader.h"
+
+static ProcFile proc_stat = PROCFS_FILE_INIT("/proc/stat");
 
 // Read CPU statistics from /proc/stat
 int read_cpu_stats(CPUStats *stats) {
-    FILE *fp;
-    char buffer[256];
-    
-    fp = fopen("/proc/stat", "r");
-    if (fp == NULL) {
-        perror("Error opening /proc/stat");
+    return read_cpu_core_stats(stats, NULL) < 0 ? -1 : 0;
+}
+
+// Read the aggregate line and, if cores is given, every cpuN line from a
+// single read of /proc/stat. Cores beyond cores->stride are not stored.
+// Returns the number of cores /proc/stat reports (possibly more than were
+// stored, so the caller can grow its arrays), or -1 on error.
+int read_cpu_core_stats(CPUStats *stats, CoreStats *cores) {
+    const char *p = procfs_read(&proc_stat);
+    if (p == NULL) {
         return -1;
     }
 
-    // Read the first line which contains CPU statistics
-    if (fgets(buffer, sizeof(buffer), fp) == NULL) {
-        perror("Error reading /proc/stat");
-        fclose(fp);
+    // The first line contains the aggregate CPU statistics
+    // Format: cpu user nice system idle iowait irq softirq steal guest guest_nice
+    if (strncmp(p, "cpu ", 4) != 0) {
+        fprintf(stderr, "Unexpected /proc/stat format\n");
         return -1;
     }
+    p += 4;
 
-    // Parse CPU statistics
-    // Format: cpu user nice system idle iowait irq softirq steal guest guest_nice
-    sscanf(buffer, "cpu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu",
-           &stats->user, &stats->nice, &stats->system, &stats->idle,
-           &stats->iowait, &stats->irq, &stats->softirq, &stats->steal,
-           &stats->guest, &stats->guest_nice);
+    stats->user = procfs_next_ulong(&p);
+    stats->nice = procfs_next_ulong(&p);
+    stats->system = procfs_next_ulong(&p);
+    stats->idle = procfs_next_ulong(&p);
+    stats->iowait = procfs_next_ulong(&p);
+    stats->irq = procfs_next_ulong(&p);
+    stats->softirq = procfs_next_ulong(&p);
+    stats->steal = procfs_next_ulong(&p);
+    stats->guest = procfs_next_ulong(&p);
+    stats->guest_nice = procfs_next_ulong(&p);
 
     // Calculate total CPU time
     stats->total_time = stats->user + stats->nice + stats->system + stats->idle +
                        stats->iowait + stats->irq + stats->softirq + stats->steal;
 
-    fclose(fp);
-    return 0;
+    // Per-core lines follow directly. Offline cores have no line, so the
+    // arrays are cleared first and their counters stay zero.
+    int found = 0;
+    if (cores) {
+        memset(cores->counters, 0, (size_t)CORE_FIELD_COUNT * cores->stride * sizeof(uint64_t));
+    }
+    for (p = procfs_next_line(p); p && strncmp(p, "cpu", 3) == 0; p = procfs_next_line(p)) {
+        p += 3;
+        int core = (int)procfs_next_ulong(&p);
+        if (core >= found) found = core + 1;
+        if (!cores || core >= cores->stride) continue;
+
+        for (int f = 0; f < CORE_FIELD_COUNT; f++) {
+            cores->counters[f * cores->stride + core] = procfs_next_ulong(&p);
+        }
+    }
+    if (cores) {
+        cores->count = found < cores->stride ? found : cores->stride;
+    }
+
+    return found;
 }
 
 // Calculate CPU usage percentage
@@ -63,7 +94,65 @@ float calculate_cpu_usage(CPUStats *prev, CPUStats *current) {
     return cpu_usage;
 }
 
+// Interval delta of one counter as a float. Deltas are narrowed to 32
+// bits first, which holds over a year of jiffies, because 32-bit integer
+// to float conversion has a SIMD form on every target.
+static inline float core_delta(const uint64_t *restrict before, int before_stride,
+                               const uint64_t *restrict after, int after_stride,
+                               int field, int core) {
+    return (float)(int32_t)(after[field * after_stride + core] - before[field * before_stride + core]);
+}
+
+// Split each core's interval into busy, iowait, steal and irq shares.
+// Every field sits in its own array and cores are taken CORE_LANES at a
+// time, so the inner loop has a fixed trip count, no branches and (with
+// the restrict parameters) no aliasing, and the compiler turns it into SIMD
+// code even at -O2. Arrays are padded to whole blocks, so there is no tail.
+static void core_usage_blocks(const uint64_t *restrict before, int ps,
+                              const uint64_t *restrict after, int cs, int count,
+                              float *restrict busy, float *restrict iowait,
+                              float *restrict steal, float *restrict irq) {
+    for (int base = 0; base < count; base += CORE_LANES) {
+        for (int l = 0; l < CORE_LANES; l++) {
+            int i = base + l;
+            float user = core_delta(before, ps, after, cs, CORE_USER, i);
+            float nice = core_delta(before, ps, after, cs, CORE_NICE, i);
+            float system = core_delta(before, ps, after, cs, CORE_SYSTEM, i);
+            float idle = core_delta(before, ps, after, cs, CORE_IDLE, i);
+            float io = core_delta(before, ps, after, cs, CORE_IOWAIT, i);
+            float hardirq = core_delta(before, ps, after, cs, CORE_IRQ, i);
+            float softirq = core_delta(before, ps, after, cs, CORE_SOFTIRQ, i);
+            float stolen = core_delta(before, ps, after, cs, CORE_STEAL, i);
+            float total = user + nice + system + idle + io + hardirq + softirq + stolen;
+
+            // Branch-free guard against an empty interval (all deltas zero)
+            float scale = 100.0f / (total + (float)(total == 0.0f));
+
+            busy[i] = (total - idle - io) * scale;
+            iowait[i] = io * scale;
+            steal[i] = stolen * scale;
+            irq[i] = (hardirq + softirq) * scale;
+        }
+    }
+}
+
+// Per-core usage over the interval between two samples
+void calculate_core_usage(const CoreStats *prev, const CoreStats *curr, CoreUsage *usage) {
+    int count = prev->count < curr->count ? prev->count : curr->count;
+
+    core_usage_blocks(prev->counters, prev->stride, curr->counters, curr->stride, count,
+                      usage->busy, usage->iowait, usage->steal, usage->irq);
+}
+
 // Print CPU usage information
 void print_cpu_info(float usage) {
     printf("CPU Usage: %.2f%%\n", usage);
-} 
\ No newline at end of file
+}
+
+// Print one line per core
+void print_core_info(const CoreUsage *usage, int count) {
+    for (int i = 0; i < count; i++) {
+        printf("  cpu%-4d %6.2f%%   iowait %5.2f%%   steal %5.2f%%   irq %5.2f%%\n",
+               i, usage->busy[i], usage->iowait[i], usage->steal[i], usage->irq[i]);
+    }
+}
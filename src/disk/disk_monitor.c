@@ -1,45 +1,110 @@
 #include "../../include/disk_monitor.h"
+#include "../../include/procfs_reader.h"
+#include <fnmatch.h>
 
-// Read disk I/O statistics from /proc/diskstats
+static ProcFile proc_diskstats = PROCFS_FILE_INIT("/proc/diskstats");
+
+// Parse one /proc/diskstats line. Fields the kernel does not report are
+// left zero: procfs_next_ulong stops at the end of the line.
+// Format: major minor name reads_completed reads_merged sectors_read ms_reading
+//         writes_completed writes_merged sectors_written ms_writing in_flight
+//         io_ticks time_in_queue [discards merged sectors ms] [flushes ms]
+static void parse_disk_line(const char *p, const char *name, size_t name_len, DiskStats *stats) {
+    unsigned int major = (unsigned int)procfs_next_ulong(&p);
+    unsigned int minor = (unsigned int)procfs_next_ulong(&p);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->major = major;
+    stats->minor = minor;
+    if (name_len >= sizeof(stats->name)) name_len = sizeof(stats->name) - 1;
+    memcpy(stats->name, name, name_len);
+
+    p = name + name_len;
+    stats->reads_completed = procfs_next_ulong(&p);
+    stats->reads_merged = procfs_next_ulong(&p);
+    stats->sectors_read = procfs_next_ulong(&p);
+    stats->time_reading = procfs_next_ulong(&p);
+    stats->writes_completed = procfs_next_ulong(&p);
+    stats->writes_merged = procfs_next_ulong(&p);
+    stats->sectors_written = procfs_next_ulong(&p);
+    stats->time_writing = procfs_next_ulong(&p);
+    stats->in_flight = procfs_next_ulong(&p);
+    stats->io_ticks = procfs_next_ulong(&p);
+    stats->time_in_queue = procfs_next_ulong(&p);
+    stats->discards_completed = procfs_next_ulong(&p);
+    stats->discards_merged = procfs_next_ulong(&p);
+    stats->sectors_discarded = procfs_next_ulong(&p);
+    stats->time_discarding = procfs_next_ulong(&p);
+    stats->flushes_completed = procfs_next_ulong(&p);
+    stats->time_flushing = procfs_next_ulong(&p);
+}
+
+// Locate the device name on a line; returns its length
+static size_t disk_line_name(const char *line, const char **name) {
+    const char *p = procfs_skip_field(procfs_skip_field(line));
+    while (*p == ' ') p++;
+    *name = p;
+    return (size_t)(procfs_skip_field(p) - p);
+}
+
+// Read disk I/O statistics for one device from /proc/diskstats
 int read_disk_stats(const char *device, DiskStats *stats) {
-    FILE *fp;
-    char line[512];
-    char current_device[MAX_DISK_NAME_LEN];
-    
-    fp = fopen("/proc/diskstats", "r");
-    if (fp == NULL) {
-        perror("Error opening /proc/diskstats");
+    const char *line = procfs_read(&proc_diskstats);
+    size_t device_len = strlen(device);
+
+    if (line == NULL) {
         return -1;
     }
 
-    // Read disk statistics line by line
-    while (fgets(line, sizeof(line), fp)) {
-        // Parse disk statistics
-        // Format: major minor name reads_completed reads_merged sectors_read ms_reading writes_completed writes_merged sectors_written ms_writing
-        if (sscanf(line, "%*d %*d %s %lu %lu %lu %lu %lu %lu %lu %lu",
-                   current_device,
-                   &stats->reads_completed,
-                   &stats->reads_merged,
-                   &stats->sectors_read,
-                   &stats->time_reading,
-                   &stats->writes_completed,
-                   &stats->writes_merged,
-                   &stats->sectors_written,
-                   &stats->time_writing) == 9) {
-            
-            // Check if this is the device we're looking for
-            if (strcmp(current_device, device) == 0) {
-                fclose(fp);
-                return 0;
-            }
+    for (; line; line = procfs_next_line(line)) {
+        const char *name;
+        size_t name_len = disk_line_name(line, &name);
+        if (name_len == device_len && memcmp(name, device, device_len) == 0) {
+            parse_disk_line(line, name, name_len, stats);
+            return 0;
         }
     }
 
-    fclose(fp);
     fprintf(stderr, "Device %s not found\n", device);
     return -1;
 }
 
+// Read every device in one pass over /proc/diskstats, optionally keeping
+// only names that match the glob pattern (NULL or "" keeps everything).
+// At most max_devices are stored; returns how many matched, which may be
+// more so the caller can grow its table, or -1 on error.
+int read_all_disk_stats(DiskStats *devices, int max_devices, const char *pattern) {
+    const char *line = procfs_read(&proc_diskstats);
+    int found = 0;
+
+    if (line == NULL) {
+        return -1;
+    }
+    if (pattern && !*pattern) {
+        pattern = NULL;
+    }
+
+    for (; line; line = procfs_next_line(line)) {
+        const char *name;
+        size_t name_len = disk_line_name(line, &name);
+        if (name_len == 0 || name_len >= MAX_DISK_NAME_LEN) continue;
+
+        if (pattern) {
+            char buf[MAX_DISK_NAME_LEN];
+            memcpy(buf, name, name_len);
+            buf[name_len] = '\0';
+            if (fnmatch(pattern, buf, 0) != 0) continue;
+        }
+
+        if (found < max_devices) {
+            parse_disk_line(line, name, name_len, &devices[found]);
+        }
+        found++;
+    }
+
+    return found;
+}
+
 // Calculate disk I/O speeds
 void calculate_disk_usage(DiskStats *prev, DiskStats *current, float *read_speed, float *write_speed) {
     unsigned long sectors_read_diff = current->sectors_read - prev->sectors_read;
@@ -50,10 +115,81 @@ void calculate_disk_usage(DiskStats *prev, DiskStats *current, float *read_speed
     *write_speed = (float)(sectors_written_diff * 512) / (1024 * 1024);
 }
 
+// Find name in prev, trying position hint first: /proc/diskstats lists
+// devices in a stable order, so the hint almost always hits
+static const DiskStats *find_disk(const DiskStats *prev, int prev_count, const char *name, int hint) {
+    if (hint < prev_count && strcmp(prev[hint].name, name) == 0) {
+        return &prev[hint];
+    }
+    for (int i = 0; i < prev_count; i++) {
+        if (strcmp(prev[i].name, name) == 0) {
+            return &prev[i];
+        }
+    }
+    return NULL;
+}
+
+// Derive iostat-style rates for every device present in both samples,
+// matching devices by name. Devices that have never completed a request
+// (unused loop and ram devices) are left out. Returns the number of
+// entries written to rates.
+int calculate_disk_rates(const DiskStats *prev, int prev_count, const DiskStats *curr, int curr_count,
+                         float elapsed_sec, DiskRates *rates) {
+    int n = 0;
+    float elapsed_ms = elapsed_sec * 1000.0f;
+
+    if (elapsed_sec <= 0.0f) {
+        return 0;
+    }
+
+    for (int i = 0; i < curr_count; i++) {
+        const DiskStats *c = &curr[i];
+        if (c->reads_completed + c->writes_completed + c->discards_completed == 0) continue;
+
+        const DiskStats *p = find_disk(prev, prev_count, c->name, i);
+        if (!p) continue;  // New device: no baseline yet
+
+        unsigned long reads = c->reads_completed - p->reads_completed;
+        unsigned long writes = c->writes_completed - p->writes_completed;
+        unsigned long discards = c->discards_completed - p->discards_completed;
+        unsigned long requests = reads + writes + discards;
+        unsigned long wait = (c->time_reading - p->time_reading) +
+                             (c->time_writing - p->time_writing) +
+                             (c->time_discarding - p->time_discarding);
+        DiskRates *r = &rates[n++];
+
+        memcpy(r->name, c->name, sizeof(r->name));
+        r->read_iops = reads / elapsed_sec;
+        r->write_iops = writes / elapsed_sec;
+        r->discard_iops = discards / elapsed_sec;
+        r->read_mb_s = (c->sectors_read - p->sectors_read) * 512.0f / (1024 * 1024) / elapsed_sec;
+        r->write_mb_s = (c->sectors_written - p->sectors_written) * 512.0f / (1024 * 1024) / elapsed_sec;
+        r->await_ms = requests ? (float)wait / requests : 0.0f;
+        r->queue_depth = (c->time_in_queue - p->time_in_queue) / elapsed_ms;
+        r->util_percent = (c->io_ticks - p->io_ticks) * 100.0f / elapsed_ms;
+        if (r->util_percent > 100.0f) r->util_percent = 100.0f;
+        r->in_flight = c->in_flight;
+    }
+    return n;
+}
+
 // Print disk I/O information
 void print_disk_info(float read_speed, float write_speed) {
     printf("\nDisk I/O Information:\n");
     printf("Read Speed: %.2f MB/s\n", read_speed);
     printf("Write Speed: %.2f MB/s\n", write_speed);
     printf("Total I/O: %.2f MB/s\n", read_speed + write_speed);
-} 
\ No newline at end of file
+}
+
+// Print one line per device
+void print_disk_rates(const DiskRates *rates, int count) {
+    printf("\nDisk I/O Information:\n");
+    printf("%-16s %8s %8s %8s %9s %9s %9s %7s %6s\n",
+           "DEVICE", "r/s", "w/s", "d/s", "rMB/s", "wMB/s", "await ms", "aqu-sz", "%util");
+    for (int i = 0; i < count; i++) {
+        const DiskRates *r = &rates[i];
+        printf("%-16s %8.1f %8.1f %8.1f %9.2f %9.2f %9.2f %7.2f %6.1f\n",
+               r->name, r->read_iops, r->write_iops, r->discard_iops, r->read_mb_s,
+               r->write_mb_s, r->await_ms, r->queue_depth, r->util_percent);
+    }
+}
@@ -9,14 +9,66 @@ void signal_handler(int signum) {
     }
 }
 
+// Size the previous-sample copy and the usage arrays for stride cores.
+// The usage arrays share one allocation.
+static int grow_core_buffers(CoreStats *prev, CoreUsage *usage, int stride) {
+    uint64_t *counters = calloc((size_t)CORE_FIELD_COUNT * stride, sizeof(uint64_t));
+    float *shares = calloc((size_t)4 * stride, sizeof(float));
+    if (!counters || !shares) {
+        fprintf(stderr, "Failed to allocate per-core buffers\n");
+        free(counters);
+        free(shares);
+        return -1;
+    }
+
+    free(prev->counters);
+    free(usage->busy);
+    prev->counters = counters;
+    prev->stride = stride;
+    prev->count = 0;  // Start over; the next sample becomes the baseline
+    usage->busy = shares;
+    usage->iowait = shares + stride;
+    usage->steal = shares + 2 * stride;
+    usage->irq = shares + 3 * stride;
+    return 0;
+}
+
+// Grow the previous-sample copy of the disk table (keeping its first
+// prev_count entries) and the rate array to hold count devices
+static int grow_disk_buffers(DiskStats **prev, DiskRates **rates, int prev_count, int count) {
+    DiskStats *grown_prev = malloc(count * sizeof(DiskStats));
+    DiskRates *grown_rates = malloc(count * sizeof(DiskRates));
+    if (!grown_prev || !grown_rates) {
+        fprintf(stderr, "Failed to allocate disk buffers\n");
+        free(grown_prev);
+        free(grown_rates);
+        return -1;
+    }
+
+    if (*prev) {
+        memcpy(grown_prev, *prev, prev_count * sizeof(DiskStats));
+    }
+    free(*prev);
+    free(*rates);
+    *prev = grown_prev;
+    *rates = grown_rates;
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     MonitorConfig config;
     SharedData *shared_data;
-    sem_t *sem;
+    Snapshot *snap;
     float cpu_usage = 0.0;
-    float read_speed = 0.0, write_speed = 0.0;
     CPUStats prev_cpu_stats = {0};
-    DiskStats prev_disk_stats = {0};
+    CoreStats prev_cores = {0};
+    CoreUsage core_usage = {0};
+    int core_capacity = 0;
+    DiskStats *prev_disks = NULL;
+    DiskRates *disk_rates = NULL;
+    int prev_disk_count = 0, disk_rate_count = 0, disk_capacity = 0;
+    uint64_t prev_disk_time = 0;
+    uint64_t last_generation = 0;
     bool first_reading = true;
 
     // Parse command line arguments
@@ -24,8 +76,13 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    // Set up signal handler
-    signal(SIGINT, signal_handler);
+    // Set up signal handler. No SA_RESTART, so Ctrl+C interrupts the
+    // futex wait below instead of being retried by the kernel.
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
 
     // Attach to shared memory
     shared_data = attach_shared_memory();
@@ -34,22 +91,23 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    // Open semaphore
-    sem = open_semaphore();
-    if (!sem) {
-        fprintf(stderr, "Failed to open semaphore\n");
-        destroy_shared_memory(shared_data);
-        return 1;
-    }
+    ProcessInfo top_processes[MAX_TOP_PROCESSES];
 
     printf("Display process started (Press Ctrl+C to exit)\n");
 
     // Main display loop
     while (running) {
-        // Wait for semaphore
-        sem_wait(sem);
+        // Sleep until the collector publishes a new generation
+        if (wait_for_snapshot(shared_data, last_generation, -1) < 0) {
+            break;
+        }
+
+        // read_snapshot hands back a private copy, so reading never blocks
+        // the collector; it also follows the segment when it grows
+        if (snapshot_generation(shared_data) != last_generation &&
+            (snap = read_snapshot(shared_data)) != NULL) {
+            last_generation = snap->generation;
 
-        if (shared_data->data_ready) {
             // Clear screen
             printf("\033[2J\033[H");
             printf("System Monitor (Press Ctrl+C to exit)\n");
@@ -58,52 +116,89 @@ int main(int argc, char *argv[]) {
             // Display CPU stats
             if (config.monitor_cpu) {
                 if (!first_reading) {
-                    cpu_usage = calculate_cpu_usage(&prev_cpu_stats, &shared_data->cpu_stats);
+                    cpu_usage = calculate_cpu_usage(&prev_cpu_stats, &snap->cpu_stats);
                 }
                 print_cpu_info(cpu_usage);
-                prev_cpu_stats = shared_data->cpu_stats;
+                prev_cpu_stats = snap->cpu_stats;
+
+                if (config.show_cores) {
+                    CoreStats cores;
+                    snapshot_cores(snap, &cores);
+                    if (cores.stride > core_capacity &&
+                        grow_core_buffers(&prev_cores, &core_usage, cores.stride) == 0) {
+                        core_capacity = cores.stride;
+                    }
+                    if (cores.stride <= core_capacity) {
+                        if (prev_cores.count > 0) {
+                            calculate_core_usage(&prev_cores, &cores, &core_usage);
+                            print_core_info(&core_usage, cores.count < prev_cores.count ?
+                                                         cores.count : prev_cores.count);
+                        }
+                        // Keep our own copy; the snapshot buffer is reused
+                        memcpy(prev_cores.counters, cores.counters,
+                               (size_t)CORE_FIELD_COUNT * cores.stride * sizeof(uint64_t));
+                        prev_cores.stride = cores.stride;
+                        prev_cores.count = cores.count;
+                    }
+                }
             }
 
             // Display memory stats
             if (config.monitor_memory) {
-                print_memory_info(&shared_data->memory_stats);
+                print_memory_info(&snap->memory_stats);
             }
 
             // Display disk stats
             if (config.monitor_disk) {
-                if (!first_reading) {
-                    calculate_disk_usage(&prev_disk_stats, &shared_data->disk_stats,
-                                      &read_speed, &write_speed);
+                if (snap->sampled_at.disk > prev_disk_time) {
+                    DiskStats *disks = snapshot_disks(snap);
+                    if (snap->disk_count > disk_capacity &&
+                        grow_disk_buffers(&prev_disks, &disk_rates, prev_disk_count,
+                                          snap->disk_count) == 0) {
+                        disk_capacity = snap->disk_count;
+                    }
+                    int count = snap->disk_count < disk_capacity ? snap->disk_count : disk_capacity;
+
+                    if (prev_disk_time > 0) {
+                        float elapsed = (snap->sampled_at.disk - prev_disk_time) / 1e9f;
+                        disk_rate_count = calculate_disk_rates(prev_disks, prev_disk_count,
+                                                               disks, count, elapsed, disk_rates);
+                    }
+                    memcpy(prev_disks, disks, count * sizeof(DiskStats));
+                    prev_disk_count = count;
+                    prev_disk_time = snap->sampled_at.disk;
                 }
-                print_disk_info(read_speed, write_speed);
-                prev_disk_stats = shared_data->disk_stats;
+                print_disk_rates(disk_rates, disk_rate_count);
             }
 
             // Display process stats
-            if (config.monitor_processes && shared_data->process_count > 0) {
-                print_process_list(shared_data->processes, 
-                                 shared_data->process_count < config.num_processes ? 
-                                 shared_data->process_count : config.num_processes);
+            if (config.monitor_processes && snap->process_count > 0) {
+                // Use the collector's ranking for our sort key
+                ProcessInfo *processes = snapshot_processes(snap);
+                int shown = snap->top_count[config.sort_key];
+                if (shown > config.num_processes) shown = config.num_processes;
+                for (int i = 0; i < shown; i++) {
+                    top_processes[i] = processes[snap->top[config.sort_key][i]];
+                }
+                print_process_list(top_processes, shown);
             }
 
             // Display Docker stats
-            if (config.monitor_docker && shared_data->docker_count > 0) {
-                print_docker_stats_list(shared_data->docker_stats, shared_data->docker_count);
+            if (config.monitor_docker && snap->docker_count > 0) {
+                print_docker_stats_list(snapshot_docker_stats(snap), snap->docker_count);
             }
 
             first_reading = false;
+            fflush(stdout);
         }
-
-        // Release semaphore
-        sem_post(sem);
-
-        // Small delay to prevent too frequent updates
-        usleep(100000);  // 100ms
     }
 
     // Cleanup
+    free(prev_disks);
+    free(disk_rates);
+    free(prev_cores.counters);
+    free(core_usage.busy);
     destroy_shared_memory(shared_data);
-    close_semaphore(sem);
 
     printf("\nDisplay process terminated\n");
     return 0;
@@ -1,8 +1,28 @@
 #include "docker_monitor.h"
 
+// One in-flight stats request. Handles are reused across containers and
+// cycles, so their connections to the daemon stay open.
+typedef struct {
+    CURL *easy;
+    docker_api_response_t resp;
+    int container;   // Index of the container being fetched
+    char error[CURL_ERROR_SIZE];
+} docker_request_t;
+
 static CURL *curl;
 static char error_buffer[CURL_ERROR_SIZE];
 
+// Concurrent per-container stats requests
+static struct {
+    CURLM *multi;
+    docker_request_t *requests;
+    int concurrency;
+    long timeout_ms;
+} pool = {
+    .concurrency = DOCKER_DEFAULT_CONCURRENCY,
+    .timeout_ms = DOCKER_DEFAULT_TIMEOUT_MS,
+};
+
 // Callback function to handle Docker API response
 static size_t write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
     size_t realsize = size * nmemb;
@@ -31,6 +51,13 @@ static size_t write_callback(void *contents, size_t size, size_t nmemb, void *us
     return realsize;
 }
 
+// Limit how many stats requests run at once and how long each may take.
+// Call before init_docker_monitor.
+void set_docker_request_limits(int concurrency, long timeout_ms) {
+    pool.concurrency = concurrency > 0 ? concurrency : DOCKER_DEFAULT_CONCURRENCY;
+    pool.timeout_ms = timeout_ms > 0 ? timeout_ms : DOCKER_DEFAULT_TIMEOUT_MS;
+}
+
 int init_docker_monitor(void) {
     curl_global_init(CURL_GLOBAL_DEFAULT);
     curl = curl_easy_init();
@@ -42,12 +69,52 @@ int init_docker_monitor(void) {
     curl_easy_setopt(curl, CURLOPT_UNIX_SOCKET_PATH, "/var/run/docker.sock");
     curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error_buffer);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L); // 5 seconds timeout
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, pool.timeout_ms);
+
+    // Stats requests go through a multi handle, pool.concurrency at a time
+    pool.multi = curl_multi_init();
+    pool.requests = calloc(pool.concurrency, sizeof(docker_request_t));
+    if (!pool.multi || !pool.requests) {
+        fprintf(stderr, "Failed to initialize Docker request pool\n");
+        cleanup_docker_monitor();
+        return -1;
+    }
+    curl_multi_setopt(pool.multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, (long)pool.concurrency);
+
+    for (int i = 0; i < pool.concurrency; i++) {
+        docker_request_t *req = &pool.requests[i];
+        req->easy = curl_easy_init();
+        if (!req->easy) {
+            fprintf(stderr, "Failed to initialize CURL\n");
+            cleanup_docker_monitor();
+            return -1;
+        }
+        curl_easy_setopt(req->easy, CURLOPT_UNIX_SOCKET_PATH, "/var/run/docker.sock");
+        curl_easy_setopt(req->easy, CURLOPT_ERRORBUFFER, req->error);
+        curl_easy_setopt(req->easy, CURLOPT_WRITEFUNCTION, write_callback);
+        curl_easy_setopt(req->easy, CURLOPT_WRITEDATA, &req->resp);
+        curl_easy_setopt(req->easy, CURLOPT_PRIVATE, req);
+        curl_easy_setopt(req->easy, CURLOPT_TIMEOUT_MS, pool.timeout_ms);
+    }
     
     return 0;
 }
 
 void cleanup_docker_monitor(void) {
+    if (pool.requests) {
+        for (int i = 0; i < pool.concurrency; i++) {
+            if (pool.requests[i].easy) {
+                curl_easy_cleanup(pool.requests[i].easy);
+            }
+            free(pool.requests[i].resp.data);
+        }
+        free(pool.requests);
+        pool.requests = NULL;
+    }
+    if (pool.multi) {
+        curl_multi_cleanup(pool.multi);
+        pool.multi = NULL;
+    }
     if (curl) {
         curl_easy_cleanup(curl);
         curl = NULL;
@@ -127,6 +194,93 @@ static int get_container_list(char ***container_ids, int *count) {
     return 0;
 }
 
+// Fill stats from one /containers/{id}/stats response
+static int parse_container_stats(const char *id, const char *json, docker_stats_t *stats) {
+    struct json_object *root = json_tokener_parse(json);
+    if (!root) {
+        fprintf(stderr, "Failed to parse JSON response for container %s\n", id);
+        return -1;
+    }
+
+    // Fill container stats
+    strncpy(stats->id, id, sizeof(stats->id) - 1);
+    
+    struct json_object *name, *cpu_stats, *memory_stats, *blkio_stats;
+    
+    if (json_object_object_get_ex(root, "name", &name)) {
+        const char *name_str = json_object_get_string(name);
+        if (name_str) {
+            strncpy(stats->name, name_str + 1, sizeof(stats->name) - 1); // Skip leading '/'
+        }
+    }
+
+    // CPU stats
+    if (json_object_object_get_ex(root, "cpu_stats", &cpu_stats)) {
+        struct json_object *cpu_usage;
+        if (json_object_object_get_ex(cpu_stats, "cpu_usage", &cpu_usage)) {
+            struct json_object *total_usage;
+            if (json_object_object_get_ex(cpu_usage, "total_usage", &total_usage)) {
+                stats->cpu_usage = json_object_get_double(total_usage) / 1000000000.0; // Convert to seconds
+            }
+        }
+    }
+
+    // Memory stats
+    if (json_object_object_get_ex(root, "memory_stats", &memory_stats)) {
+        struct json_object *usage, *limit;
+        if (json_object_object_get_ex(memory_stats, "usage", &usage) &&
+            json_object_object_get_ex(memory_stats, "limit", &limit)) {
+            stats->memory_usage = json_object_get_double(usage);
+            stats->memory_limit = json_object_get_double(limit);
+            if (stats->memory_limit > 0) {
+                stats->memory_percentage = (stats->memory_usage / stats->memory_limit) * 100.0;
+            }
+        }
+    }
+
+    // Block I/O stats
+    if (json_object_object_get_ex(root, "blkio_stats", &blkio_stats)) {
+        struct json_object *io_service_bytes_recursive;
+        if (json_object_object_get_ex(blkio_stats, "io_service_bytes_recursive", &io_service_bytes_recursive)) {
+            if (json_object_get_type(io_service_bytes_recursive) == json_type_array) {
+                int len = json_object_array_length(io_service_bytes_recursive);
+                for (int j = 0; j < len; j++) {
+                    struct json_object *io_stat = json_object_array_get_idx(io_service_bytes_recursive, j);
+                    struct json_object *op, *value;
+                    if (json_object_object_get_ex(io_stat, "op", &op) &&
+                        json_object_object_get_ex(io_stat, "value", &value)) {
+                        const char *op_str = json_object_get_string(op);
+                        if (strcmp(op_str, "Read") == 0) {
+                            stats->block_read = json_object_get_double(value);
+                        } else if (strcmp(op_str, "Write") == 0) {
+                            stats->block_write = json_object_get_double(value);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    json_object_put(root);
+    return 0;
+}
+
+// Point a pooled handle at the next container and hand it to the multi handle
+static int start_stats_request(docker_request_t *req, int container, const char *id) {
+    char url[512];
+
+    snprintf(url, sizeof(url), "http://localhost/v1.41/containers/%s/stats?stream=false", id);
+    req->container = container;
+    req->resp.size = 0;
+    req->error[0] = '\0';
+    curl_easy_setopt(req->easy, CURLOPT_URL, url);
+    if (curl_multi_add_handle(pool.multi, req->easy) != CURLM_OK) {
+        fprintf(stderr, "Failed to queue stats request for container %s\n", id);
+        return -1;
+    }
+    return 0;
+}
+
 int get_docker_stats(docker_stats_t **stats, int *count) {
     char **container_ids = NULL;
     int container_count = 0;
@@ -152,96 +306,62 @@ int get_docker_stats(docker_stats_t **stats, int *count) {
     }
     *count = container_count;
 
-    for (int i = 0; i < container_count; i++) {
-        if (!container_ids[i]) continue;
+    // Keep up to pool.concurrency requests in flight. The daemon spends
+    // about a second sampling CPU for each stream=false request, so running
+    // them side by side makes a cycle cost roughly one request.
+    int next = 0, active = 0;
+    for (int r = 0; r < pool.concurrency; r++) {
+        while (next < container_count && !container_ids[next]) next++;
+        if (next == container_count) break;
+        if (start_stats_request(&pool.requests[r], next, container_ids[next]) == 0) active++;
+        next++;
+    }
 
-        docker_api_response_t resp = {0};
-        char url[512];
-        snprintf(url, sizeof(url), "http://localhost/v1.41/containers/%s/stats?stream=false", container_ids[i]);
-        
-        curl_easy_setopt(curl, CURLOPT_URL, url);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &resp);
-        
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            fprintf(stderr, "Failed to get stats for container %s: %s\n", container_ids[i], error_buffer);
-            continue;
-        }
+    while (active > 0) {
+        int running, pending;
+        CURLMsg *msg;
 
-        if (!resp.data) {
-            fprintf(stderr, "No stats data received for container %s\n", container_ids[i]);
-            continue;
-        }
+        curl_multi_perform(pool.multi, &running);
+        while ((msg = curl_multi_info_read(pool.multi, &pending)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) continue;
 
-        struct json_object *root = json_tokener_parse(resp.data);
-        if (!root) {
-            fprintf(stderr, "Failed to parse JSON response for container %s\n", container_ids[i]);
-            free(resp.data);
-            continue;
-        }
+            docker_request_t *req;
+            CURLcode res = msg->data.result;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&req);
+            curl_multi_remove_handle(pool.multi, req->easy);
+            active--;
 
-        // Fill container stats
-        strncpy((*stats)[i].id, container_ids[i], sizeof((*stats)[i].id) - 1);
-        
-        struct json_object *name, *cpu_stats, *memory_stats, *blkio_stats;
-        
-        if (json_object_object_get_ex(root, "name", &name)) {
-            const char *name_str = json_object_get_string(name);
-            if (name_str) {
-                strncpy((*stats)[i].name, name_str + 1, sizeof((*stats)[i].name) - 1); // Skip leading '/'
+            const char *id = container_ids[req->container];
+            if (res != CURLE_OK) {
+                fprintf(stderr, "Failed to get stats for container %s: %s\n", id,
+                        req->error[0] ? req->error : curl_easy_strerror(res));
+            } else if (req->resp.size == 0) {
+                fprintf(stderr, "No stats data received for container %s\n", id);
+            } else {
+                parse_container_stats(id, req->resp.data, &(*stats)[req->container]);
             }
-        }
-
-        // CPU stats
-        if (json_object_object_get_ex(root, "cpu_stats", &cpu_stats)) {
-            struct json_object *cpu_usage;
-            if (json_object_object_get_ex(cpu_stats, "cpu_usage", &cpu_usage)) {
-                struct json_object *total_usage;
-                if (json_object_object_get_ex(cpu_usage, "total_usage", &total_usage)) {
-                    (*stats)[i].cpu_usage = json_object_get_double(total_usage) / 1000000000.0; // Convert to seconds
-                }
-            }
-        }
 
-        // Memory stats
-        if (json_object_object_get_ex(root, "memory_stats", &memory_stats)) {
-            struct json_object *usage, *limit;
-            if (json_object_object_get_ex(memory_stats, "usage", &usage) &&
-                json_object_object_get_ex(memory_stats, "limit", &limit)) {
-                (*stats)[i].memory_usage = json_object_get_double(usage);
-                (*stats)[i].memory_limit = json_object_get_double(limit);
-                if ((*stats)[i].memory_limit > 0) {
-                    (*stats)[i].memory_percentage = ((*stats)[i].memory_usage / (*stats)[i].memory_limit) * 100.0;
-                }
+            // Reuse the handle for the next container
+            while (next < container_count && !container_ids[next]) next++;
+            if (next < container_count) {
+                if (start_stats_request(req, next, container_ids[next]) == 0) active++;
+                next++;
             }
         }
 
-        // Block I/O stats
-        if (json_object_object_get_ex(root, "blkio_stats", &blkio_stats)) {
-            struct json_object *io_service_bytes_recursive;
-            if (json_object_object_get_ex(blkio_stats, "io_service_bytes_recursive", &io_service_bytes_recursive)) {
-                if (json_object_get_type(io_service_bytes_recursive) == json_type_array) {
-                    int len = json_object_array_length(io_service_bytes_recursive);
-                    for (int j = 0; j < len; j++) {
-                        struct json_object *io_stat = json_object_array_get_idx(io_service_bytes_recursive, j);
-                        struct json_object *op, *value;
-                        if (json_object_object_get_ex(io_stat, "op", &op) &&
-                            json_object_object_get_ex(io_stat, "value", &value)) {
-                            const char *op_str = json_object_get_string(op);
-                            if (strcmp(op_str, "Read") == 0) {
-                                (*stats)[i].block_read = json_object_get_double(value);
-                            } else if (strcmp(op_str, "Write") == 0) {
-                                (*stats)[i].block_write = json_object_get_double(value);
-                            }
-                        }
-                    }
-                }
-            }
+        if (active > 0) {
+            curl_multi_poll(pool.multi, NULL, 0, 1000, NULL);
         }
+    }
 
-        json_object_put(root);
-        free(resp.data);
+    // Drop containers whose stats could not be fetched, keeping list order
+    int fetched = 0;
+    for (int i = 0; i < container_count; i++) {
+        if ((*stats)[i].id[0] == '\0') continue;
+        if (fetched != i) (*stats)[fetched] = (*stats)[i];
+        fetched++;
     }
+    *count = fetched;
 
     // Cleanup
     for (int i = 0; i < container_count; i++) {
@@ -1,10 +1,75 @@
 #include "../../include/shared_memory.h"
+#include <stddef.h>
+#include <time.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#define SHM_ALIGN 64
+
+static size_t align_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+// Bytes taken by the per-core arrays for a given stride
+static size_t core_table_size(uint32_t core_capacity) {
+    return (size_t)CORE_FIELD_COUNT * core_capacity * sizeof(uint64_t);
+}
+
+// Fill in the table offsets for the capacities in layout; returns the
+// resulting slot size
+static size_t layout_slot(SnapshotLayout *layout) {
+    layout->processes_offset = align_up(sizeof(Snapshot), SHM_ALIGN);
+    layout->docker_offset = align_up(layout->processes_offset +
+                                     (size_t)layout->process_capacity * sizeof(ProcessInfo), SHM_ALIGN);
+    layout->cores_offset = align_up(layout->docker_offset +
+                                    (size_t)layout->docker_capacity * sizeof(docker_stats_t), SHM_ALIGN);
+    layout->disks_offset = align_up(layout->cores_offset + core_table_size(layout->core_capacity),
+                                    SHM_ALIGN);
+    return align_up(offsetof(SnapshotSlot, data) + layout->disks_offset +
+                    (size_t)layout->disk_capacity * sizeof(DiskStats), SHM_ALIGN);
+}
+
+static SnapshotSlot *slot_at(const SharedData *data, uint32_t index) {
+    return (SnapshotSlot *)((char *)data->header + data->header->slot_offset +
+                            (size_t)index * data->header->slot_size);
+}
+
+// Map size bytes of the segment, replacing any previous mapping
+static int map_segment(SharedData *data, size_t size) {
+    ShmHeader *header = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, data->fd, 0);
+    if (header == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    if (data->header) {
+        munmap(data->header, data->mapped_size);
+    }
+    data->header = header;
+    data->mapped_size = size;
+    return 0;
+}
 
 // Create and initialize shared memory segment
 SharedData* create_shared_memory(void) {
-    int fd;
     SharedData *data;
     mode_t old_umask;
+    long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    SnapshotLayout layout = {
+        .process_capacity = SHM_INITIAL_PROCESSES,
+        .docker_capacity = SHM_INITIAL_CONTAINERS,
+        .core_capacity = align_up(cpus > 0 ? (size_t)cpus : 1, CORE_LANES),
+        .disk_capacity = SHM_INITIAL_DISKS,
+    };
+    size_t slot_size = layout_slot(&layout);
+    size_t slot_offset = align_up(sizeof(ShmHeader), SHM_ALIGN);
+    size_t size = slot_offset + SNAPSHOT_SLOTS * slot_size;
+
+    data = calloc(1, sizeof(SharedData));
+    if (!data) {
+        fprintf(stderr, "Failed to allocate shared memory handle\n");
+        return NULL;
+    }
 
     // Remove any existing shared memory object first
     shm_unlink(SHM_NAME);
@@ -13,140 +78,408 @@ SharedData* create_shared_memory(void) {
     old_umask = umask(0);
 
     // Create shared memory object with world read/write permissions
-    fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+    data->fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
     
     // Restore original umask
     umask(old_umask);
 
-    if (fd == -1) {
+    if (data->fd == -1) {
         perror("shm_open");
+        free(data);
         return NULL;
     }
 
     // Set the size of shared memory object
-    if (ftruncate(fd, sizeof(SharedData)) == -1) {
+    if (ftruncate(data->fd, size) == -1) {
         perror("ftruncate");
-        close(fd);
+        close(data->fd);
         shm_unlink(SHM_NAME);
+        free(data);
         return NULL;
     }
 
     // Map shared memory object into process address space
-    data = mmap(NULL, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (data == MAP_FAILED) {
-        perror("mmap");
-        close(fd);
+    if (map_segment(data, size) != 0) {
+        close(data->fd);
         shm_unlink(SHM_NAME);
+        free(data);
         return NULL;
     }
 
-    // Initialize shared memory
-    memset(data, 0, sizeof(SharedData));
-    data->data_ready = false;
+    // The new object is zero-filled; describe the layout, then stamp the
+    // magic last so attaching readers never see a half-built header
+    ShmHeader *header = data->header;
+    header->version = SHM_VERSION;
+    header->slot_offset = slot_offset;
+    header->slot_size = slot_size;
+    header->layout = layout;
+    atomic_store_explicit(&header->size, size, memory_order_relaxed);
+    for (uint32_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+        slot_at(data, i)->data.layout = layout;
+    }
+    atomic_thread_fence(memory_order_release);
+    header->magic = SHM_MAGIC;
 
-    close(fd);
     return data;
 }
 
 // Attach to existing shared memory segment
 SharedData* attach_shared_memory(void) {
-    int fd;
     SharedData *data;
+    struct stat st;
     int retries = 0;
     const int max_retries = 5;
 
-    // Try to open shared memory with retries
-    while (retries < max_retries) {
-        fd = shm_open(SHM_NAME, O_RDWR, 0666);
-        if (fd != -1) break;
-        
-        fprintf(stderr, "Retry %d: Waiting for shared memory...\n", retries + 1);
+    data = calloc(1, sizeof(SharedData));
+    if (!data) {
+        fprintf(stderr, "Failed to allocate shared memory handle\n");
+        return NULL;
+    }
+
+    // Try to open shared memory with retries. The collector may still be
+    // sizing the segment or filling in its header.
+    for (;;) {
+        data->fd = shm_open(SHM_NAME, O_RDWR, 0666);
+        if (data->fd != -1) {
+            if (fstat(data->fd, &st) == 0 && (size_t)st.st_size >= sizeof(ShmHeader) &&
+                map_segment(data, sizeof(ShmHeader)) == 0) {
+                if (data->header->magic == SHM_MAGIC) break;
+                munmap(data->header, data->mapped_size);
+                data->header = NULL;
+            }
+            close(data->fd);
+            data->fd = -1;
+        }
+
+        if (++retries > max_retries) {
+            fprintf(stderr, "Shared memory segment %s is not available\n", SHM_NAME);
+            free(data);
+            return NULL;
+        }
+        fprintf(stderr, "Retry %d: Waiting for shared memory...\n", retries);
         sleep(1);  // Wait a bit before retrying
-        retries++;
     }
 
-    if (fd == -1) {
-        perror("shm_open");
+    atomic_thread_fence(memory_order_acquire);
+    if (data->header->version != SHM_VERSION) {
+        fprintf(stderr, "Shared memory version %u does not match this build (%u)\n",
+                data->header->version, SHM_VERSION);
+        destroy_shared_memory(data);
         return NULL;
     }
 
-    // Map shared memory object into process address space
-    data = mmap(NULL, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (data == MAP_FAILED) {
-        perror("mmap");
-        close(fd);
+    // Now map the whole segment
+    if (map_segment(data, atomic_load_explicit(&data->header->size, memory_order_acquire)) != 0) {
+        destroy_shared_memory(data);
         return NULL;
     }
 
-    close(fd);
     return data;
 }
 
 // Destroy shared memory segment
 void destroy_shared_memory(SharedData *data) {
     if (data) {
-        munmap(data, sizeof(SharedData));
+        if (data->header) {
+            munmap(data->header, data->mapped_size);
+        }
+        if (data->fd >= 0) {
+            close(data->fd);
+        }
+        free(data->copy);
+        free(data);
         shm_unlink(SHM_NAME);
     }
 }
 
-// Create and initialize semaphore
-sem_t* create_semaphore(void) {
-    sem_t *sem;
-    mode_t old_umask;
+// Locate the tables that follow a snapshot
+ProcessInfo* snapshot_processes(const Snapshot *snap) {
+    return (ProcessInfo *)((char *)snap + snap->layout.processes_offset);
+}
 
-    // Remove any existing semaphore first
-    sem_unlink(SEM_NAME);
+docker_stats_t* snapshot_docker_stats(const Snapshot *snap) {
+    return (docker_stats_t *)((char *)snap + snap->layout.docker_offset);
+}
 
-    // Set umask to ensure proper permissions
-    old_umask = umask(0);
+void snapshot_cores(const Snapshot *snap, CoreStats *cores) {
+    cores->counters = (uint64_t *)((char *)snap + snap->layout.cores_offset);
+    cores->stride = (int)snap->layout.core_capacity;
+    cores->count = snap->core_count;
+}
 
-    // Create semaphore with world read/write permissions
-    sem = sem_open(SEM_NAME, O_CREAT | O_EXCL, 0666, 1);
+DiskStats* snapshot_disks(const Snapshot *snap) {
+    return (DiskStats *)((char *)snap + snap->layout.disks_offset);
+}
 
-    // Restore original umask
-    umask(old_umask);
+// Thin wrapper; glibc provides no futex() function.
+// The segment is shared between processes, so the non-private ops are used.
+static long futex(_Atomic uint32_t *uaddr, int op, uint32_t val, const struct timespec *timeout) {
+    return syscall(SYS_futex, (uint32_t *)uaddr, op, val, timeout, NULL, 0);
+}
 
-    if (sem == SEM_FAILED) {
-        perror("sem_open");
-        return NULL;
-    }
+// Current CLOCK_MONOTONIC time in nanoseconds
+uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Claim the back buffer for the next snapshot.
+// Only the collector calls this; the slot is marked as being written so a
+// reader that races with it retries instead of seeing a torn copy.
+Snapshot* begin_snapshot(SharedData *data) {
+    uint32_t latest = atomic_load_explicit(&data->header->latest, memory_order_relaxed);
+    SnapshotSlot *slot = slot_at(data, (latest + 1) % SNAPSHOT_SLOTS);
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
 
-    return sem;
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    memset(&slot->data.sampled_at, 0, sizeof(slot->data.sampled_at));
+    memset(&slot->data.proc_events, 0, sizeof(slot->data.proc_events));
+    slot->data.core_count = 0;
+    slot->data.disk_count = 0;
+    slot->data.process_count = 0;
+    slot->data.scan_syscalls = 0;
+    memset(slot->data.top_count, 0, sizeof(slot->data.top_count));
+    slot->data.docker_count = 0;
+    return &slot->data;
 }
 
-// Open existing semaphore
-sem_t* open_semaphore(void) {
-    sem_t *sem;
-    int retries = 0;
-    const int max_retries = 5;
+// Make a snapshot obtained from begin_snapshot visible to readers
+void publish_snapshot(SharedData *data, Snapshot *snap) {
+    ShmHeader *header = data->header;
+    SnapshotSlot *slot = (SnapshotSlot *)((char *)snap - offsetof(SnapshotSlot, data));
+    uint32_t index = (uint32_t)(((char *)slot - (char *)header - header->slot_offset) / header->slot_size);
+    uint64_t generation = atomic_load_explicit(&header->generation, memory_order_relaxed) + 1;
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    struct timespec now;
 
-    // Try to open semaphore with retries
-    while (retries < max_retries) {
-        sem = sem_open(SEM_NAME, 0);
-        if (sem != SEM_FAILED) break;
-        
-        fprintf(stderr, "Retry %d: Waiting for semaphore...\n", retries + 1);
-        sleep(1);  // Wait a bit before retrying
-        retries++;
+    clock_gettime(CLOCK_REALTIME, &now);
+    snap->wall_time_ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    snap->generation = generation;
+
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_release);
+    atomic_store_explicit(&header->latest, index, memory_order_release);
+    atomic_store_explicit(&header->generation, generation, memory_order_release);
+
+    // Wake every reader sleeping in wait_for_snapshot
+    atomic_fetch_add_explicit(&header->wake_seq, 1, memory_order_release);
+    futex(&header->wake_seq, FUTEX_WAKE, INT_MAX, NULL);
+}
+
+// Grow the per-slot tables, keeping the contents of every slot.
+// Readers see layout_seq odd for the duration and retry until it settles.
+int reserve_snapshot(SharedData *data, Snapshot **snap, const SnapshotLayout *need) {
+    ShmHeader *header = data->header;
+    SnapshotLayout old_layout = header->layout;
+    SnapshotLayout layout = old_layout;
+
+    // Double past the request so a slowly growing host resizes rarely.
+    // Doubling keeps the core stride a multiple of CORE_LANES.
+    while (layout.process_capacity < need->process_capacity) layout.process_capacity *= 2;
+    while (layout.docker_capacity < need->docker_capacity) layout.docker_capacity *= 2;
+    while (layout.core_capacity < need->core_capacity) layout.core_capacity *= 2;
+    while (layout.disk_capacity < need->disk_capacity) layout.disk_capacity *= 2;
+    if (layout.process_capacity == old_layout.process_capacity &&
+        layout.docker_capacity == old_layout.docker_capacity &&
+        layout.core_capacity == old_layout.core_capacity &&
+        layout.disk_capacity == old_layout.disk_capacity) {
+        return 0;
     }
 
-    if (sem == SEM_FAILED) {
-        perror("sem_open");
-        return NULL;
+    size_t slot_size = layout_slot(&layout);
+    size_t old_slot_size = header->slot_size;
+    size_t size = header->slot_offset + SNAPSHOT_SLOTS * slot_size;
+    uint32_t index = (uint32_t)(((char *)*snap - offsetof(SnapshotSlot, data) - (char *)header -
+                                 header->slot_offset) / old_slot_size);
+
+    // Slots move, so work from a copy of the old ones
+    char *old_slots = malloc(SNAPSHOT_SLOTS * old_slot_size);
+    if (!old_slots) {
+        fprintf(stderr, "Failed to allocate shared memory resize buffer\n");
+        return -1;
+    }
+    memcpy(old_slots, (char *)header + header->slot_offset, SNAPSHOT_SLOTS * old_slot_size);
+
+    if (ftruncate(data->fd, size) == -1) {
+        perror("ftruncate");
+        free(old_slots);
+        return -1;
+    }
+    if (map_segment(data, size) != 0) {
+        free(old_slots);
+        return -1;
+    }
+    header = data->header;
+
+    uint64_t layout_seq = atomic_load_explicit(&header->layout_seq, memory_order_relaxed);
+    atomic_store_explicit(&header->layout_seq, layout_seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    header->slot_size = slot_size;
+    header->layout = layout;
+    for (uint32_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+        SnapshotSlot *old = (SnapshotSlot *)(old_slots + i * old_slot_size);
+        SnapshotSlot *slot = slot_at(data, i);
+        Snapshot *dst = &slot->data;
+        CoreStats old_cores, new_cores;
+
+        memcpy(slot, old, sizeof(SnapshotSlot));
+        dst->layout = layout;
+        if (dst->process_count > (int)old_layout.process_capacity) {
+            dst->process_count = (int)old_layout.process_capacity;
+        }
+        if (dst->docker_count > (int)old_layout.docker_capacity) {
+            dst->docker_count = (int)old_layout.docker_capacity;
+        }
+        if (dst->core_count > (int)old_layout.core_capacity) {
+            dst->core_count = (int)old_layout.core_capacity;
+        }
+        if (dst->disk_count > (int)old_layout.disk_capacity) {
+            dst->disk_count = (int)old_layout.disk_capacity;
+        }
+        memcpy(snapshot_processes(dst), snapshot_processes(&old->data),
+               (size_t)dst->process_count * sizeof(ProcessInfo));
+        memcpy(snapshot_docker_stats(dst), snapshot_docker_stats(&old->data),
+               (size_t)dst->docker_count * sizeof(docker_stats_t));
+        memcpy(snapshot_disks(dst), snapshot_disks(&old->data),
+               (size_t)dst->disk_count * sizeof(DiskStats));
+
+        // The core arrays change stride; copy them field by field and keep
+        // the padding zero
+        snapshot_cores(&old->data, &old_cores);
+        snapshot_cores(dst, &new_cores);
+        memset(new_cores.counters, 0, core_table_size(layout.core_capacity));
+        for (int f = 0; f < CORE_FIELD_COUNT; f++) {
+            memcpy(new_cores.counters + f * new_cores.stride, old_cores.counters + f * old_cores.stride,
+                   (size_t)old_cores.stride * sizeof(uint64_t));
+        }
     }
+    free(old_slots);
 
-    return sem;
+    atomic_store_explicit(&header->size, size, memory_order_relaxed);
+    atomic_store_explicit(&header->layout_seq, layout_seq + 2, memory_order_release);
+
+    *snap = &slot_at(data, index)->data;
+    printf("Shared memory resized to %zu bytes (%u processes, %u containers, %u cores, "
+           "%u disks per snapshot)\n", size, layout.process_capacity, layout.docker_capacity,
+           layout.core_capacity, layout.disk_capacity);
+    return 0;
 }
 
-// Close semaphore
-void close_semaphore(sem_t *sem) {
-    if (sem) {
-        sem_close(sem);
+// Make sure the private copy can hold a snapshot with the given layout
+static int reserve_copy(SharedData *data, size_t size) {
+    if (data->copy_size < size) {
+        Snapshot *grown = realloc(data->copy, size);
+        if (!grown) {
+            fprintf(stderr, "Failed to allocate snapshot buffer\n");
+            return -1;
+        }
+        data->copy = grown;
+        data->copy_size = size;
     }
+    return 0;
 }
 
-// Destroy semaphore
-void destroy_semaphore(void) {
-    sem_unlink(SEM_NAME);
-} 
\ No newline at end of file
+// Copy the latest consistent snapshot into the handle's private buffer.
+// Only the used part of each table is copied. Returns NULL if nothing has
+// been published yet or the copy could not be made.
+Snapshot* read_snapshot(SharedData *data) {
+    for (;;) {
+        ShmHeader *header = data->header;
+        uint64_t layout_seq = atomic_load_explicit(&header->layout_seq, memory_order_acquire);
+        if (layout_seq & 1) {
+            continue;  // Collector is resizing the slots
+        }
+
+        // The segment grew since we mapped it: follow it
+        size_t size = atomic_load_explicit(&header->size, memory_order_acquire);
+        if (size > data->mapped_size) {
+            if (map_segment(data, size) != 0) return NULL;
+            continue;
+        }
+
+        if (atomic_load_explicit(&header->generation, memory_order_acquire) == 0) {
+            return NULL;
+        }
+
+        SnapshotLayout layout = header->layout;
+        size_t slot_size = layout_slot(&layout);
+        if (header->slot_offset + SNAPSHOT_SLOTS * slot_size > data->mapped_size) {
+            continue;  // Raced with a resize; the layout check above will catch up
+        }
+        if (reserve_copy(data, slot_size) != 0) return NULL;
+
+        uint32_t latest = atomic_load_explicit(&header->latest, memory_order_acquire);
+        SnapshotSlot *slot = (SnapshotSlot *)((char *)header + header->slot_offset +
+                                              (latest % SNAPSHOT_SLOTS) * slot_size);
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq & 1) {
+            continue;  // Writer lapped us and is refilling this slot
+        }
+
+        Snapshot *out = data->copy;
+        memcpy(out, &slot->data, sizeof(Snapshot));
+
+        // Trust the header's layout over the (possibly torn) copied one
+        out->layout = layout;
+        if (out->process_count < 0 || out->process_count > (int)layout.process_capacity) {
+            out->process_count = 0;
+        }
+        if (out->docker_count < 0 || out->docker_count > (int)layout.docker_capacity) {
+            out->docker_count = 0;
+        }
+        if (out->core_count < 0 || out->core_count > (int)layout.core_capacity) {
+            out->core_count = 0;
+        }
+        if (out->disk_count < 0 || out->disk_count > (int)layout.disk_capacity) {
+            out->disk_count = 0;
+        }
+        memcpy(snapshot_processes(out), (char *)&slot->data + layout.processes_offset,
+               (size_t)out->process_count * sizeof(ProcessInfo));
+        memcpy(snapshot_docker_stats(out), (char *)&slot->data + layout.docker_offset,
+               (size_t)out->docker_count * sizeof(docker_stats_t));
+        memcpy((char *)out + layout.cores_offset, (char *)&slot->data + layout.cores_offset,
+               core_table_size(layout.core_capacity));
+        memcpy(snapshot_disks(out), (char *)&slot->data + layout.disks_offset,
+               (size_t)out->disk_count * sizeof(DiskStats));
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) == seq &&
+            atomic_load_explicit(&header->layout_seq, memory_order_relaxed) == layout_seq) {
+            return out;
+        }
+    }
+}
+
+// Block on the wake_seq futex until a new generation appears
+int wait_for_snapshot(SharedData *data, uint64_t last_generation, int timeout_ms) {
+    struct timespec timeout;
+
+    if (timeout_ms >= 0) {
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    }
+
+    for (;;) {
+        // Sample the futex word before checking, so a publication between
+        // the check and the wait makes FUTEX_WAIT return immediately
+        uint32_t seq = atomic_load_explicit(&data->header->wake_seq, memory_order_acquire);
+        if (atomic_load_explicit(&data->header->generation, memory_order_acquire) != last_generation) {
+            return 1;
+        }
+
+        if (futex(&data->header->wake_seq, FUTEX_WAIT, seq, timeout_ms >= 0 ? &timeout : NULL) == -1) {
+            if (errno == EAGAIN) continue;
+            if (errno == ETIMEDOUT || errno == EINTR) return 0;
+            perror("futex");
+            return -1;
+        }
+    }
+}
+
+// Generation of the last published snapshot (0 if none)
+uint64_t snapshot_generation(SharedData *data) {
+    return atomic_load_explicit(&data->header->generation, memory_order_acquire);
+}
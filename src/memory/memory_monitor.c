@@ -1,40 +1,48 @@
 #include "../../include/memory_monitor.h"
+#include "../../include/procfs_reader.h"
+
+static ProcFile proc_meminfo = PROCFS_FILE_INIT("/proc/meminfo");
 
 // Read memory statistics from /proc/meminfo
 int read_memory_stats(MemoryStats *stats) {
-    FILE *fp;
-    char line[256];
-    unsigned long value;
-    
-    fp = fopen("/proc/meminfo", "r");
-    if (fp == NULL) {
-        perror("Error opening /proc/meminfo");
+    const char *line = procfs_read(&proc_meminfo);
+    if (line == NULL) {
         return -1;
     }
 
     // Initialize all values to 0
     memset(stats, 0, sizeof(MemoryStats));
 
-    // Read memory information line by line
-    while (fgets(line, sizeof(line), fp)) {
-        if (sscanf(line, "MemTotal: %lu kB", &value) == 1) {
-            stats->total = value;
-        } else if (sscanf(line, "MemFree: %lu kB", &value) == 1) {
-            stats->free = value;
-        } else if (sscanf(line, "MemAvailable: %lu kB", &value) == 1) {
-            stats->available = value;
-        } else if (sscanf(line, "Buffers: %lu kB", &value) == 1) {
-            stats->buffers = value;
-        } else if (sscanf(line, "Cached: %lu kB", &value) == 1) {
-            stats->cached = value;
-        } else if (sscanf(line, "SwapTotal: %lu kB", &value) == 1) {
-            stats->swap_total = value;
-        } else if (sscanf(line, "SwapFree: %lu kB", &value) == 1) {
-            stats->swap_free = value;
+    // Walk the buffer line by line; each line is "Key:   value kB"
+    for (; line; line = procfs_next_line(line)) {
+        const char *value = strchr(line, ':');
+        unsigned long *field = NULL;
+        if (!value) continue;
+
+        size_t key_len = value - line;
+        value++;
+
+        if (key_len == 8 && memcmp(line, "MemTotal", 8) == 0) {
+            field = &stats->total;
+        } else if (key_len == 7 && memcmp(line, "MemFree", 7) == 0) {
+            field = &stats->free;
+        } else if (key_len == 12 && memcmp(line, "MemAvailable", 12) == 0) {
+            field = &stats->available;
+        } else if (key_len == 7 && memcmp(line, "Buffers", 7) == 0) {
+            field = &stats->buffers;
+        } else if (key_len == 6 && memcmp(line, "Cached", 6) == 0) {
+            field = &stats->cached;
+        } else if (key_len == 9 && memcmp(line, "SwapTotal", 9) == 0) {
+            field = &stats->swap_total;
+        } else if (key_len == 8 && memcmp(line, "SwapFree", 8) == 0) {
+            field = &stats->swap_free;
+        }
+
+        if (field) {
+            *field = procfs_next_ulong(&value);
         }
     }
 
-    fclose(fp);
     return 0;
 }
 
@@ -0,0 +1,158 @@
+#include "../../include/pid_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PID_INDEX_MIN_CAPACITY 64
+
+// Mix pid and starttime into a table position
+static size_t pid_hash(pid_t pid, unsigned long starttime, size_t mask) {
+    uint64_t h = (uint64_t)(uint32_t)pid * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t)starttime * 0xC2B2AE3D27D4EB4FULL;
+    h ^= h >> 29;
+    return (size_t)h & mask;
+}
+
+// Place an entry without checking the load factor
+static void pid_index_place(PidIndex *index, pid_t pid, unsigned long starttime, int slot) {
+    size_t mask = index->capacity - 1;
+    size_t pos = pid_hash(pid, starttime, mask);
+
+    while (index->entries[pos].epoch == index->epoch) {
+        PidIndexEntry *entry = &index->entries[pos];
+        if (entry->pid == pid && entry->starttime == starttime) {
+            entry->slot = slot;
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    index->entries[pos].pid = pid;
+    index->entries[pos].starttime = starttime;
+    index->entries[pos].slot = slot;
+    index->entries[pos].epoch = index->epoch;
+    index->count++;
+}
+
+// Initialize an index sized for the expected number of processes
+int pid_index_init(PidIndex *index, size_t expected) {
+    memset(index, 0, sizeof(*index));
+    index->epoch = 1;
+    return pid_index_reserve(index, expected);
+}
+
+// Release index storage
+void pid_index_free(PidIndex *index) {
+    free(index->entries);
+    memset(index, 0, sizeof(*index));
+}
+
+// Drop all entries in O(1)
+void pid_index_clear(PidIndex *index) {
+    index->count = 0;
+    if (++index->epoch == 0) {
+        // Epoch wrapped: stale entries could look live again, wipe them
+        memset(index->entries, 0, index->capacity * sizeof(PidIndexEntry));
+        index->epoch = 1;
+    }
+}
+
+// Make room for at least expected entries at a load factor of 1/2
+int pid_index_reserve(PidIndex *index, size_t expected) {
+    size_t capacity = PID_INDEX_MIN_CAPACITY;
+    while (capacity < expected * 2) {
+        capacity <<= 1;
+    }
+    if (capacity <= index->capacity) {
+        return 0;
+    }
+
+    PidIndexEntry *old_entries = index->entries;
+    size_t old_capacity = index->capacity;
+    uint32_t old_epoch = index->epoch;
+
+    index->entries = calloc(capacity, sizeof(PidIndexEntry));
+    if (!index->entries) {
+        fprintf(stderr, "Failed to allocate PID index\n");
+        index->entries = old_entries;
+        return -1;
+    }
+    index->capacity = capacity;
+    index->count = 0;
+    index->epoch = 1;
+
+    // Rehash the live entries into the new table
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_entries[i].epoch == old_epoch) {
+            pid_index_place(index, old_entries[i].pid, old_entries[i].starttime, old_entries[i].slot);
+        }
+    }
+
+    free(old_entries);
+    return 0;
+}
+
+// Map (pid, starttime) to slot, replacing any previous mapping
+int pid_index_insert(PidIndex *index, pid_t pid, unsigned long starttime, int slot) {
+    if ((index->count + 1) * 2 > index->capacity &&
+        pid_index_reserve(index, index->count + 1) != 0) {
+        return -1;
+    }
+    pid_index_place(index, pid, starttime, slot);
+    return 0;
+}
+
+// Find the slot for (pid, starttime), or -1 if it is not indexed
+int pid_index_lookup(const PidIndex *index, pid_t pid, unsigned long starttime) {
+    if (index->capacity == 0) {
+        return -1;
+    }
+
+    size_t mask = index->capacity - 1;
+    size_t pos = pid_hash(pid, starttime, mask);
+
+    while (index->entries[pos].epoch == index->epoch) {
+        const PidIndexEntry *entry = &index->entries[pos];
+        if (entry->pid == pid && entry->starttime == starttime) {
+            return entry->slot;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+// Delete (pid, starttime); returns the slot it mapped to, or -1.
+// Uses backward-shift deletion so lookups never need tombstones.
+int pid_index_remove(PidIndex *index, pid_t pid, unsigned long starttime) {
+    if (index->capacity == 0) {
+        return -1;
+    }
+
+    size_t mask = index->capacity - 1;
+    size_t hole = pid_hash(pid, starttime, mask);
+
+    while (index->entries[hole].epoch == index->epoch) {
+        if (index->entries[hole].pid == pid && index->entries[hole].starttime == starttime) {
+            break;
+        }
+        hole = (hole + 1) & mask;
+    }
+    if (index->entries[hole].epoch != index->epoch) {
+        return -1;
+    }
+    int slot = index->entries[hole].slot;
+
+    // Pull later entries of the probe run back into the hole when their
+    // home position does not lie cyclically within (hole, pos]
+    for (size_t pos = (hole + 1) & mask; index->entries[pos].epoch == index->epoch; pos = (pos + 1) & mask) {
+        size_t home = pid_hash(index->entries[pos].pid, index->entries[pos].starttime, mask);
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            index->entries[hole] = index->entries[pos];
+            hole = pos;
+        }
+    }
+
+    index->entries[hole].epoch = 0;
+    index->count--;
+    return slot;
+}
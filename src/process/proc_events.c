@@ -0,0 +1,281 @@
+#include "../../include/proc_events.h"
+#include "../../include/process_scan.h"
+#include "../../include/pid_index.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#define PROC_EVENTS_RCVBUF (4 * 1024 * 1024)
+#define PROC_EVENTS_INITIAL 1024
+
+// A PID the event stream says is alive
+typedef struct {
+    pid_t pid;
+    uid_t uid;
+    bool known_owner;  // uid has been read since the last fork/exec
+    bool sampled;      // Has appeared in at least one published list
+} LivePid;
+
+// Live PID set maintained from PROC_EVENT_FORK/EXEC/EXIT. PIDs are kept
+// densely in live[] for cheap iteration; index maps (pid, 0) to a position.
+static struct {
+    int sock;
+    bool seeded;       // live[] reflects a full scan plus later events
+    LivePid *live;
+    int count;
+    int capacity;
+    PidIndex index;
+    ProcEventCounts pending;
+    TrackedPid *request;
+    int request_capacity;
+} events = { .sock = -1 };
+
+// Send a PROC_CN_MCAST_LISTEN/IGNORE request to the connector
+static int proc_events_subscribe(enum proc_cn_mcast_op op) {
+    char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    struct cn_msg *msg = NLMSG_DATA(nlh);
+
+    memset(buf, 0, sizeof(buf));
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+    nlh->nlmsg_type = NLMSG_DONE;
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(op);
+    memcpy(msg->data, &op, sizeof(op));
+
+    return send(events.sock, buf, nlh->nlmsg_len, 0) < 0 ? -1 : 0;
+}
+
+// Subscribe to the netlink proc connector. Needs CAP_NET_ADMIN; returns -1
+// when unavailable so the caller can stay on full /proc scans.
+int proc_events_open(void) {
+    struct sockaddr_nl addr;
+    int rcvbuf = PROC_EVENTS_RCVBUF;
+
+    events.sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (events.sock < 0) {
+        perror("socket(NETLINK_CONNECTOR)");
+        return -1;
+    }
+
+    // A deep receive queue rides out fork storms between samples; if it
+    // still overflows we notice ENOBUFS and rescan
+    if (setsockopt(events.sock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) != 0) {
+        setsockopt(events.sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    if (bind(events.sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        proc_events_subscribe(PROC_CN_MCAST_LISTEN) != 0) {
+        perror("proc connector subscribe");
+        close(events.sock);
+        events.sock = -1;
+        return -1;
+    }
+
+    if (pid_index_init(&events.index, PROC_EVENTS_INITIAL) != 0) {
+        proc_events_close();
+        return -1;
+    }
+    events.seeded = false;
+    return 0;
+}
+
+// Unsubscribe and release the live set
+void proc_events_close(void) {
+    if (events.sock >= 0) {
+        proc_events_subscribe(PROC_CN_MCAST_IGNORE);
+        close(events.sock);
+        events.sock = -1;
+    }
+    pid_index_free(&events.index);
+    free(events.live);
+    free(events.request);
+    events.live = NULL;
+    events.request = NULL;
+    events.count = events.capacity = events.request_capacity = 0;
+}
+
+// Add a PID to the live set (no-op if present)
+static LivePid *live_add(pid_t pid) {
+    int pos = pid_index_lookup(&events.index, pid, 0);
+    if (pos >= 0) {
+        return &events.live[pos];
+    }
+
+    if (events.count == events.capacity) {
+        int capacity = events.capacity ? events.capacity * 2 : PROC_EVENTS_INITIAL;
+        LivePid *grown = realloc(events.live, capacity * sizeof(LivePid));
+        if (!grown) {
+            fprintf(stderr, "Failed to grow live PID set\n");
+            return NULL;
+        }
+        events.live = grown;
+        events.capacity = capacity;
+    }
+
+    LivePid *entry = &events.live[events.count];
+    memset(entry, 0, sizeof(*entry));
+    entry->pid = pid;
+    pid_index_insert(&events.index, pid, 0, events.count);
+    events.count++;
+    return entry;
+}
+
+// Remove the entry at pos by moving the last entry into its place
+static void live_remove_at(int pos) {
+    pid_index_remove(&events.index, events.live[pos].pid, 0);
+    events.count--;
+    if (pos != events.count) {
+        events.live[pos] = events.live[events.count];
+        pid_index_insert(&events.index, events.live[pos].pid, 0, pos);
+    }
+}
+
+// Apply one connector event to the live set
+static void proc_events_apply(const struct proc_event *ev) {
+    int pos;
+
+    switch (ev->what) {
+        case PROC_EVENT_FORK:
+            // Thread creation also reports a fork; only count new processes
+            if (ev->event_data.fork.child_pid != ev->event_data.fork.child_tgid) break;
+            events.pending.forks++;
+            live_add(ev->event_data.fork.child_tgid);
+            break;
+        case PROC_EVENT_EXEC:
+            events.pending.execs++;
+            pos = pid_index_lookup(&events.index, ev->event_data.exec.process_tgid, 0);
+            if (pos >= 0) {
+                events.live[pos].known_owner = false;  // setuid binaries change owner
+            } else {
+                live_add(ev->event_data.exec.process_tgid);
+            }
+            break;
+        case PROC_EVENT_EXIT:
+            if (ev->event_data.exit.process_pid != ev->event_data.exit.process_tgid) break;
+            events.pending.exits++;
+            pos = pid_index_lookup(&events.index, ev->event_data.exit.process_tgid, 0);
+            if (pos >= 0) {
+                if (!events.live[pos].sampled) {
+                    events.pending.short_lived++;
+                }
+                live_remove_at(pos);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Read every queued event without blocking.
+// Returns 1 if events were lost and the live set needs a rescan.
+static int proc_events_drain(void) {
+    char buf[64 * 1024] __attribute__((aligned(NLMSG_ALIGNTO)));
+    int lost = 0;
+
+    for (;;) {
+        ssize_t len = recv(events.sock, buf, sizeof(buf), MSG_DONTWAIT);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS) {
+                lost = 1;  // Kernel dropped events; keep draining
+                continue;
+            }
+            break;  // EAGAIN: queue is empty
+        }
+
+        for (struct nlmsghdr *nlh = (struct nlmsghdr *)buf; NLMSG_OK(nlh, (size_t)len);
+             nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_NOOP) continue;
+            if (nlh->nlmsg_type == NLMSG_ERROR || nlh->nlmsg_type == NLMSG_OVERRUN) {
+                lost = 1;
+                continue;
+            }
+
+            struct cn_msg *msg = NLMSG_DATA(nlh);
+            if (msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC) continue;
+            proc_events_apply((const struct proc_event *)msg->data);
+        }
+    }
+
+    return lost;
+}
+
+// Rebuild the live set from a full /proc scan
+static int proc_events_resync(ProcessInfo **processes, int *count, int max_processes) {
+    if (get_process_list(processes, count, max_processes) != 0) {
+        return -1;
+    }
+
+    events.count = 0;
+    pid_index_clear(&events.index);
+    for (int i = 0; i < *count; i++) {
+        LivePid *entry = live_add((*processes)[i].pid);
+        if (!entry) continue;
+        entry->uid = (*processes)[i].uid;
+        entry->known_owner = true;
+        entry->sampled = true;
+    }
+    events.seeded = true;
+    events.pending.resyncs++;
+    return 0;
+}
+
+// Get the process list by refreshing only PIDs the event stream reports as
+// alive. Falls back to a full scan on the first call and whenever events
+// were lost. counts receives the lifecycle activity since the last call.
+int proc_events_get_process_list(ProcessInfo **processes, int *count, int max_processes,
+                                 ProcEventCounts *counts) {
+    int result;
+
+    if (proc_events_drain() || !events.seeded) {
+        result = proc_events_resync(processes, count, max_processes);
+    } else {
+        int npids = events.count < max_processes ? events.count : max_processes;
+
+        if (events.request_capacity < npids) {
+            TrackedPid *grown = realloc(events.request, npids * sizeof(TrackedPid));
+            if (!grown) {
+                fprintf(stderr, "Failed to allocate PID request list\n");
+                return -1;
+            }
+            events.request = grown;
+            events.request_capacity = npids;
+        }
+        for (int i = 0; i < npids; i++) {
+            events.request[i].pid = events.live[i].pid;
+            events.request[i].uid = events.live[i].uid;
+            events.request[i].known_owner = events.live[i].known_owner;
+        }
+
+        result = get_process_list_for(events.request, npids, processes, count, max_processes);
+        if (result == 0) {
+            // Cache owners, then drop requested PIDs that could not be read:
+            // their exit event was missed or is still queued
+            bool *found = calloc(npids > 0 ? npids : 1, sizeof(bool));
+            for (int i = 0; i < *count; i++) {
+                int pos = pid_index_lookup(&events.index, (*processes)[i].pid, 0);
+                if (pos < 0) continue;
+                events.live[pos].uid = (*processes)[i].uid;
+                events.live[pos].known_owner = true;
+                events.live[pos].sampled = true;
+                if (found && pos < npids) found[pos] = true;
+            }
+            for (int pos = npids - 1; found && pos >= 0; pos--) {
+                if (!found[pos]) live_remove_at(pos);
+            }
+            free(found);
+        }
+    }
+
+    *counts = events.pending;
+    memset(&events.pending, 0, sizeof(events.pending));
+    return result;
+}
@@ -51,85 +51,176 @@ void format_size(unsigned long size_kb, char *buffer, size_t buflen) {
     }
 }
 
-// Read process statistics from /proc/[pid]/stat
-int read_proc_stat(pid_t pid, ProcessInfo *proc) {
-    char path[256];
-    char buffer[1024];
-    char state;
-    unsigned long utime, stime;
-    long starttime;
-    FILE *fp;
+// Read a small /proc file into buf with a single read() and close it.
+// Returns the number of bytes read (NUL-terminated), or -1 on error.
+static ssize_t read_small_file(const char *path, char *buf, size_t len) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    ssize_t n = read(fd, buf, len - 1);
+    close(fd);
+    if (n <= 0) return -1;
+
+    buf[n] = '\0';
+    return n;
+}
 
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    fp = fopen(path, "r");
-    if (fp == NULL) return -1;
+// System page size in KB, looked up once
+static unsigned long page_size_kb(void) {
+    static unsigned long kb;
+    if (kb == 0) {
+        long size = sysconf(_SC_PAGESIZE);
+        kb = size > 0 ? (unsigned long)size / 1024 : 4;
+    }
+    return kb;
+}
 
-    if (fgets(buffer, sizeof(buffer), fp)) {
-        // Parse the stat file
-        // Format: pid (comm) state ppid ... utime stime ...
-        char *comm_start = strchr(buffer, '(');
-        char *comm_end = strrchr(buffer, ')');
-        if (comm_start && comm_end && comm_end > comm_start) {
-            // Extract process name
-            size_t comm_len = comm_end - comm_start - 1;
-            if (comm_len > MAX_PROC_NAME - 1) comm_len = MAX_PROC_NAME - 1;
-            strncpy(proc->name, comm_start + 1, comm_len);
-            proc->name[comm_len] = '\0';
-
-            // Parse the rest of the values after the command name
-            sscanf(comm_end + 2, "%c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %*d %*d %ld",
-                   &state, &utime, &stime, &starttime);
-            
-            proc->pid = pid;  // Set the PID
-            proc->state = state;
-            proc->user_time = utime;
-            proc->system_time = stime;
-            proc->start_time = starttime;
-            return 0;
-        }
+// Parse an unsigned decimal number and advance past it
+static inline unsigned long parse_ulong(const char **cursor) {
+    const char *p = *cursor;
+    unsigned long value = 0;
+    unsigned digit;
+
+    while ((digit = (unsigned)(*p - '0')) < 10) {
+        value = value * 10 + digit;
+        p++;
     }
+    *cursor = p;
+    return value;
+}
 
-    fclose(fp);
-    return -1;
+// Skip count space-separated fields (fields may be negative numbers)
+static inline const char *skip_fields(const char *p, int count) {
+    while (count > 0 && *p) {
+        count -= (*p == ' ');
+        p++;
+    }
+    return p;
 }
 
-// Read process status information from /proc/[pid]/status
-int read_proc_status(pid_t pid, ProcessInfo *proc) {
-    char path[256];
-    char line[256];
-    FILE *fp;
+// Parse the contents of /proc/[pid]/stat.
+// Format: pid (comm) state ppid pgrp session tty_nr tpgid flags minflt
+//         cminflt majflt cmajflt utime stime cutime cstime priority nice
+//         num_threads itrealvalue starttime ...
+int parse_proc_stat(const char *buf, size_t len, ProcessInfo *proc) {
+    const char *comm_start = memchr(buf, '(', len);
+    const char *comm_end = NULL;
+    if (!comm_start) return -1;
+
+    // comm may itself contain ')', so use the last one; it is at most
+    // PROC_COMM_MAX characters long, which bounds the backwards search
+    const char *limit = comm_start + PROC_COMM_MAX + 2;
+    if (limit > buf + len) limit = buf + len;
+    for (const char *p = limit; p > comm_start; p--) {
+        if (p[-1] == ')') {
+            comm_end = p - 1;
+            break;
+        }
+    }
+    if (!comm_end || comm_end <= comm_start || comm_end + 3 > buf + len) {
+        return -1;
+    }
 
-    snprintf(path, sizeof(path), "/proc/%d/status", pid);
-    fp = fopen(path, "r");
-    if (fp == NULL) return -1;
+    // Extract process name
+    size_t comm_len = comm_end - comm_start - 1;
+    if (comm_len > MAX_PROC_NAME - 1) comm_len = MAX_PROC_NAME - 1;
+    memcpy(proc->name, comm_start + 1, comm_len);
+    proc->name[comm_len] = '\0';
+
+    // ") S 1 ..." -> state is two characters past the closing paren
+    const char *p = comm_end + 2;
+    proc->state = *p;
+
+    // Skip state..flags (7 fields) to reach the fault counters
+    p = skip_fields(p, 7);
+    proc->minor_faults = parse_ulong(&p);
+    p = skip_fields(p + 1, 1);
+    proc->major_faults = parse_ulong(&p);
+
+    // Skip cmajflt to reach utime
+    p = skip_fields(p + 1, 1);
+    proc->user_time = parse_ulong(&p);
+    p++;
+    proc->system_time = parse_ulong(&p);
+
+    // Skip cutime, cstime, priority, nice, num_threads, itrealvalue
+    p = skip_fields(p + 1, 6);
+    proc->start_time = parse_ulong(&p);
+
+    // vsize (bytes) and rss (pages) follow starttime; /proc/[pid]/status
+    // reports the same values, so callers that only need these can skip it
+    p++;
+    proc->virtual_memory = parse_ulong(&p) / 1024;
+    p++;
+    proc->memory_usage = parse_ulong(&p) * page_size_kb();
+
+    // Skip rsslim..policy (17 fields) to reach delayacct_blkio_ticks.
+    // Older kernels stop earlier, which leaves the counter at 0.
+    p = skip_fields(p + 1, 17);
+    proc->blkio_ticks = parse_ulong(&p);
+    return 0;
+}
+
+// Parse the fields we need from the contents of /proc/[pid]/status
+int parse_proc_status(const char *buf, ProcessInfo *proc) {
+    const char *line = buf;
 
     // Initialize values to 0
     proc->memory_usage = 0;
     proc->virtual_memory = 0;
     proc->uid = 0;
 
-    while (fgets(line, sizeof(line), fp)) {
-        unsigned long value;
-        if (strncmp(line, "VmRSS:", 6) == 0) {
-            if (sscanf(line, "VmRSS: %lu", &value) == 1) {
-                proc->memory_usage = value;
-            }
-        } else if (strncmp(line, "VmSize:", 7) == 0) {
-            if (sscanf(line, "VmSize: %lu", &value) == 1) {
-                proc->virtual_memory = value;
-            }
-        } else if (strncmp(line, "Uid:", 4) == 0) {
-            unsigned int uid;
-            if (sscanf(line, "Uid: %u", &uid) == 1) {
-                proc->uid = uid;
+    while (line && *line) {
+        // Only the "Uid:" and "Vm*:" lines are interesting; dispatch on the
+        // first character so most lines cost one comparison
+        if (line[0] == 'V' && line[1] == 'm') {
+            if (memcmp(line + 2, "RSS:", 4) == 0) {
+                const char *p = line + 6;
+                while (*p == ' ' || *p == '\t') p++;
+                proc->memory_usage = parse_ulong(&p);
+            } else if (memcmp(line + 2, "Size:", 5) == 0) {
+                const char *p = line + 7;
+                while (*p == ' ' || *p == '\t') p++;
+                proc->virtual_memory = parse_ulong(&p);
             }
+        } else if (line[0] == 'U' && memcmp(line, "Uid:", 4) == 0) {
+            const char *p = line + 4;
+            while (*p == ' ' || *p == '\t') p++;
+            proc->uid = (uid_t)parse_ulong(&p);
         }
+
+        line = strchr(line, '\n');
+        if (line) line++;
     }
 
-    fclose(fp);
     return 0;
 }
 
+// Read process statistics from /proc/[pid]/stat
+int read_proc_stat(pid_t pid, ProcessInfo *proc) {
+    char path[64];
+    char buffer[1024];
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    ssize_t n = read_small_file(path, buffer, sizeof(buffer));
+    if (n < 0) return -1;
+
+    if (parse_proc_stat(buffer, (size_t)n, proc) != 0) return -1;
+    proc->pid = pid;
+    return 0;
+}
+
+// Read process status information from /proc/[pid]/status
+int read_proc_status(pid_t pid, ProcessInfo *proc) {
+    char path[64];
+    char buffer[4096];
+
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    if (read_small_file(path, buffer, sizeof(buffer)) < 0) return -1;
+
+    return parse_proc_status(buffer, proc);
+}
+
 // Read process command line from /proc/[pid]/cmdline
 int read_proc_cmdline(pid_t pid, ProcessInfo *proc) {
     char path[256];
@@ -179,6 +270,24 @@ void calculate_proc_cpu_usage(ProcessInfo *prev, ProcessInfo *current, unsigned
     }
 }
 
+// Calculate page fault and block I/O delay rates for a process
+void calculate_proc_rates(ProcessInfo *prev, ProcessInfo *current, double elapsed_sec) {
+    if (elapsed_sec <= 0) {
+        current->fault_rate = 0.0;
+        current->io_delay = 0.0;
+        return;
+    }
+
+    unsigned long faults = (current->minor_faults + current->major_faults) -
+                           (prev->minor_faults + prev->major_faults);
+    current->fault_rate = (float)(faults / elapsed_sec);
+
+    long ticks_per_sec = sysconf(_SC_CLK_TCK);
+    if (ticks_per_sec <= 0) ticks_per_sec = 100;
+    unsigned long blkio = current->blkio_ticks - prev->blkio_ticks;
+    current->io_delay = (float)(blkio * 100.0 / ticks_per_sec / elapsed_sec);
+}
+
 // Compare function for sorting processes by CPU usage
 int compare_processes(const void *a, const void *b) {
     const ProcessInfo *p1 = (const ProcessInfo *)a;
@@ -189,49 +298,6 @@ int compare_processes(const void *a, const void *b) {
     return 0;
 }
 
-// Get list of all processes
-int get_process_list(ProcessInfo **processes, int *count, int max_processes) {
-    DIR *proc_dir;
-    struct dirent *entry;
-    int num_processes = 0;
-    
-    // Allocate memory for the process list
-    *processes = calloc(max_processes, sizeof(ProcessInfo));
-    if (!*processes) {
-        fprintf(stderr, "Failed to allocate memory for process list\n");
-        return -1;
-    }
-    
-    proc_dir = opendir("/proc");
-    if (proc_dir == NULL) {
-        perror("Failed to open /proc");
-        free(*processes);
-        *processes = NULL;
-        return -1;
-    }
-
-    // Scan /proc directory for processes
-    while ((entry = readdir(proc_dir)) != NULL && num_processes < max_processes) {
-        // Check if the entry is a process (directory with numeric name)
-        if (entry->d_type == DT_DIR && isdigit(entry->d_name[0])) {
-            pid_t pid = atoi(entry->d_name);
-            ProcessInfo *curr_proc = &(*processes)[num_processes];
-            
-            curr_proc->pid = pid;
-            
-            // Read process information
-            if (read_proc_stat(pid, curr_proc) == 0 &&
-                read_proc_status(pid, curr_proc) == 0) {
-                num_processes++;
-            }
-        }
-    }
-
-    closedir(proc_dir);
-    *count = num_processes;
-    return 0;
-}
-
 // Print process list header
 void print_process_header() {
     printf("\n%sTop Processes:%s\n", COLOR_BOLD, COLOR_RESET);
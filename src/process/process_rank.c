@@ -0,0 +1,108 @@
+#include "../../include/process_rank.h"
+#include <strings.h>
+
+static const char *sort_key_names[SORT_KEY_COUNT] = {
+    [SORT_CPU] = "cpu",
+    [SORT_RSS] = "rss",
+    [SORT_VIRT] = "virt",
+    [SORT_IO] = "io",
+    [SORT_FAULTS] = "faults",
+};
+
+// Value a process is ranked by for the given key
+static double sort_value(const ProcessInfo *proc, ProcessSortKey key) {
+    switch (key) {
+        case SORT_CPU:    return proc->cpu_usage;
+        case SORT_RSS:    return (double)proc->memory_usage;
+        case SORT_VIRT:   return (double)proc->virtual_memory;
+        case SORT_IO:     return proc->io_delay;
+        case SORT_FAULTS: return proc->fault_rate;
+        default:          return 0.0;
+    }
+}
+
+// Heap entry; the value is cached so the heap never re-reads ProcessInfo
+typedef struct {
+    double value;
+    pid_t pid;
+    int index;
+} RankEntry;
+
+// True if a ranks below b (lower value, ties broken by higher PID)
+static int rank_below(const RankEntry *a, const RankEntry *b) {
+    if (a->value != b->value) return a->value < b->value;
+    return a->pid > b->pid;
+}
+
+// Restore the min-heap property below position i
+static void sift_down(RankEntry *heap, int size, int i) {
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < size && rank_below(&heap[left], &heap[smallest])) smallest = left;
+        if (right < size && rank_below(&heap[right], &heap[smallest])) smallest = right;
+        if (smallest == i) return;
+
+        RankEntry tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+// Select the k highest-ranked processes without sorting the whole list.
+// A size-k min-heap holds the current top set, so the pass is O(n log k).
+// Writes indices into processes[] to top, best first; returns how many.
+int rank_top_processes(const ProcessInfo *processes, int count, ProcessSortKey key,
+                       int *top, int k) {
+    RankEntry heap[MAX_TOP_PROCESSES];
+    int size = 0;
+
+    if (k > MAX_TOP_PROCESSES) k = MAX_TOP_PROCESSES;
+    if (k <= 0) return 0;
+
+    for (int i = 0; i < count; i++) {
+        RankEntry entry = { sort_value(&processes[i], key), processes[i].pid, i };
+
+        if (size < k) {
+            // Sift up the new leaf
+            int pos = size++;
+            heap[pos] = entry;
+            while (pos > 0 && rank_below(&heap[pos], &heap[(pos - 1) / 2])) {
+                RankEntry tmp = heap[pos];
+                heap[pos] = heap[(pos - 1) / 2];
+                heap[(pos - 1) / 2] = tmp;
+                pos = (pos - 1) / 2;
+            }
+        } else if (rank_below(&heap[0], &entry)) {
+            heap[0] = entry;
+            sift_down(heap, size, 0);
+        }
+    }
+
+    // Pop the minimum repeatedly, filling the result from the back
+    int n = size;
+    while (size > 0) {
+        top[size - 1] = heap[0].index;
+        heap[0] = heap[--size];
+        sift_down(heap, size, 0);
+    }
+    return n;
+}
+
+// Name of a sort key as accepted by parse_sort_key
+const char *sort_key_name(ProcessSortKey key) {
+    return (key >= 0 && key < SORT_KEY_COUNT) ? sort_key_names[key] : "unknown";
+}
+
+// Parse a sort key name (cpu, rss, virt, io, faults)
+int parse_sort_key(const char *name, ProcessSortKey *key) {
+    for (int i = 0; i < SORT_KEY_COUNT; i++) {
+        if (strcasecmp(name, sort_key_names[i]) == 0) {
+            *key = (ProcessSortKey)i;
+            return 0;
+        }
+    }
+    return -1;
+}
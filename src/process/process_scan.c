@@ -0,0 +1,395 @@
+#include "../../include/process_monitor.h"
+#include "../../include/process_scan.h"
+#include "../../include/procfs_reader.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define PROC_DENTS_BUFFER (64 * 1024)
+
+// Entries handed to a worker at a time; small enough for stealing to even
+// out slow PIDs, large enough that the shared cursor is not contended
+#define SCAN_CHUNK 32
+
+// Record layout returned by getdents64 (glibc does not always expose it)
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// A /proc entry to read: found by the directory pass or supplied by the
+// caller through get_process_list_for
+typedef struct {
+    pid_t pid;
+    uid_t uid;
+    bool need_owner;
+    char name[12];
+} ProcEntry;
+
+// Contiguous range of entries owned by one worker. Other workers steal
+// from it by advancing the same cursor once their own shard is drained.
+typedef struct {
+    _Atomic int next;
+    int end;
+} ScanShard;
+
+// Persistent scan state: the /proc dirfd, the directory listing, and the
+// worker pool. Threads are created once by set_process_scan_workers and
+// woken for every scan; the caller's thread always acts as worker 0.
+static struct {
+    int dirfd;
+    char *dents;
+    ProcEntry *entries;
+    int entry_capacity;
+    unsigned long list_syscalls;
+
+    int workers;
+    pthread_t threads[MAX_SCAN_WORKERS];
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned long round;
+    int pending;
+    bool stop;
+
+    // Current job
+    int entry_count;
+    ProcessInfo *out;
+    ScanShard shards[MAX_SCAN_WORKERS];
+    ScanWorkerStats stats[MAX_SCAN_WORKERS];
+} scan = {
+    .dirfd = -1,
+    .workers = 1,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .start = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+static uint64_t scan_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Parse a /proc entry name as a PID; returns 0 for non-numeric names
+static pid_t parse_pid_name(const char *name) {
+    const char *p = name;
+    unsigned long pid = procfs_next_ulong(&p);
+    return (p != name && *p == '\0') ? (pid_t)pid : 0;
+}
+
+// Read one process with openat + read + fstat + close on the cached dirfd.
+// Everything except the owner comes from stat; the owner is the uid of the
+// /proc/[pid] files, which saves opening status as well. When the caller
+// already knows the owner the fstat is skipped too.
+static int scan_process(const ProcEntry *entry, ProcessInfo *proc, unsigned long *syscalls) {
+    char path[sizeof(entry->name) + sizeof("/stat")];
+    char buffer[1024];
+    struct stat st;
+    size_t name_len = strlen(entry->name);
+
+    memcpy(path, entry->name, name_len);
+    memcpy(path + name_len, "/stat", sizeof("/stat"));
+
+    int fd = openat(scan.dirfd, path, O_RDONLY | O_CLOEXEC);
+    (*syscalls)++;
+    if (fd < 0) return -1;  // Process exited since the directory was listed
+
+    ssize_t n = read(fd, buffer, sizeof(buffer) - 1);
+    int have_owner = 1;
+    if (entry->need_owner) {
+        have_owner = fstat(fd, &st) == 0;
+        (*syscalls)++;
+    } else {
+        st.st_uid = entry->uid;
+    }
+    close(fd);
+    *syscalls += 2;
+
+    if (n <= 0 || !have_owner) return -1;
+    buffer[n] = '\0';
+
+    if (parse_proc_stat(buffer, (size_t)n, proc) != 0) return -1;
+    proc->pid = entry->pid;
+    proc->uid = st.st_uid;
+    return 0;
+}
+
+// Make sure the entry list can hold max_entries
+static int reserve_entries(int max_entries) {
+    if (scan.entry_capacity < max_entries) {
+        ProcEntry *grown = realloc(scan.entries, max_entries * sizeof(ProcEntry));
+        if (!grown) {
+            fprintf(stderr, "Failed to allocate process entry list\n");
+            return -1;
+        }
+        scan.entries = grown;
+        scan.entry_capacity = max_entries;
+    }
+    return 0;
+}
+
+// Open /proc once; with rewind set, seek back to its first entry
+static int open_proc_dir(bool rewind, unsigned long *syscalls) {
+    if (scan.dirfd >= 0 && rewind) {
+        (*syscalls)++;
+        if (lseek(scan.dirfd, 0, SEEK_SET) < 0) {
+            close(scan.dirfd);
+            scan.dirfd = -1;
+        }
+    }
+    if (scan.dirfd < 0) {
+        scan.dirfd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        (*syscalls)++;
+        if (scan.dirfd < 0) {
+            perror("Failed to open /proc");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// List numeric /proc entries in large getdents64 batches
+static int list_proc_entries(int max_entries) {
+    unsigned long syscalls = 0;
+    int count = 0;
+
+    if (!scan.dents) {
+        scan.dents = malloc(PROC_DENTS_BUFFER);
+        if (!scan.dents) {
+            fprintf(stderr, "Failed to allocate directory buffer\n");
+            return -1;
+        }
+    }
+    if (open_proc_dir(true, &syscalls) != 0) {
+        return -1;
+    }
+
+    while (count < max_entries) {
+        long nread = syscall(SYS_getdents64, scan.dirfd, scan.dents, PROC_DENTS_BUFFER);
+        syscalls++;
+        if (nread < 0) {
+            perror("getdents64 on /proc");
+            break;
+        }
+        if (nread == 0) break;
+
+        for (long off = 0; off < nread && count < max_entries; ) {
+            struct linux_dirent64 *dent = (struct linux_dirent64 *)(scan.dents + off);
+            off += dent->d_reclen;
+
+            // Check if the entry is a process (directory with numeric name)
+            if (dent->d_type != DT_DIR) continue;
+            pid_t pid = parse_pid_name(dent->d_name);
+            if (pid <= 0 || strlen(dent->d_name) >= sizeof(scan.entries[0].name)) continue;
+
+            // Grow with the host rather than reserving max_entries up front
+            if (count == scan.entry_capacity &&
+                reserve_entries(scan.entry_capacity ? scan.entry_capacity * 2 : 1024) != 0) {
+                return -1;
+            }
+            scan.entries[count].pid = pid;
+            scan.entries[count].need_owner = true;
+            strcpy(scan.entries[count].name, dent->d_name);
+            count++;
+        }
+    }
+
+    scan.list_syscalls = syscalls;
+    return count;
+}
+
+// Drain this worker's own shard, then steal chunks from the others.
+// Entry i is always written to out[i], so workers never share a slot and
+// the results need no locking; failed reads leave pid 0 behind.
+static void scan_worker_run(int worker) {
+    ScanWorkerStats *stats = &scan.stats[worker];
+    uint64_t start = scan_clock_ns();
+
+    memset(stats, 0, sizeof(*stats));
+    for (int k = 0; k < scan.workers; k++) {
+        ScanShard *shard = &scan.shards[(worker + k) % scan.workers];
+        for (;;) {
+            int begin = atomic_fetch_add_explicit(&shard->next, SCAN_CHUNK, memory_order_relaxed);
+            if (begin >= shard->end) break;
+            int end = begin + SCAN_CHUNK < shard->end ? begin + SCAN_CHUNK : shard->end;
+
+            for (int i = begin; i < end; i++) {
+                if (scan_process(&scan.entries[i], &scan.out[i], &stats->syscalls) != 0) {
+                    scan.out[i].pid = 0;
+                }
+            }
+            stats->processes += end - begin;
+            if (k > 0) stats->stolen += end - begin;
+        }
+    }
+
+    stats->elapsed_ns = scan_clock_ns() - start;
+}
+
+// Background worker: wait for a round, scan, report completion
+static void *scan_worker_main(void *arg) {
+    int worker = (int)(intptr_t)arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&scan.lock);
+    for (;;) {
+        while (scan.round == seen && !scan.stop) {
+            pthread_cond_wait(&scan.start, &scan.lock);
+        }
+        if (scan.stop) break;
+        seen = scan.round;
+        pthread_mutex_unlock(&scan.lock);
+
+        scan_worker_run(worker);
+
+        pthread_mutex_lock(&scan.lock);
+        if (--scan.pending == 0) {
+            pthread_cond_signal(&scan.done);
+        }
+    }
+    pthread_mutex_unlock(&scan.lock);
+    return NULL;
+}
+
+// Stop and join the background workers
+void shutdown_process_scan(void) {
+    pthread_mutex_lock(&scan.lock);
+    scan.stop = true;
+    pthread_cond_broadcast(&scan.start);
+    pthread_mutex_unlock(&scan.lock);
+
+    for (int i = 1; i < scan.workers; i++) {
+        pthread_join(scan.threads[i], NULL);
+    }
+    scan.workers = 1;
+    scan.stop = false;
+}
+
+// Use the given number of scan threads (1 = scan on the caller's thread)
+int set_process_scan_workers(int workers) {
+    if (workers < 1) workers = 1;
+    if (workers > MAX_SCAN_WORKERS) workers = MAX_SCAN_WORKERS;
+
+    shutdown_process_scan();
+    for (int i = 1; i < workers; i++) {
+        if (pthread_create(&scan.threads[i], NULL, scan_worker_main, (void *)(intptr_t)i) != 0) {
+            fprintf(stderr, "Failed to start process scan worker %d\n", i);
+            scan.workers = i;
+            return -1;
+        }
+        scan.workers = i + 1;
+    }
+    return 0;
+}
+
+// Per-worker results of the last scan; returns the worker count
+int get_process_scan_stats(ScanWorkerStats *stats, int max_workers) {
+    int n = scan.workers < max_workers ? scan.workers : max_workers;
+    memcpy(stats, scan.stats, n * sizeof(ScanWorkerStats));
+    return n;
+}
+
+// Read scan.entries[0..entry_count) into processes on the worker pool,
+// then compact the result
+static int run_scan(int entry_count, ProcessInfo *processes, int *count) {
+    // Split the entries into one contiguous shard per worker
+    scan.entry_count = entry_count;
+    scan.out = processes;
+    for (int w = 0; w < scan.workers; w++) {
+        atomic_store_explicit(&scan.shards[w].next,
+                              (int)((long)entry_count * w / scan.workers), memory_order_relaxed);
+        scan.shards[w].end = (int)((long)entry_count * (w + 1) / scan.workers);
+    }
+
+    if (scan.workers > 1) {
+        pthread_mutex_lock(&scan.lock);
+        scan.pending = scan.workers - 1;
+        scan.round++;
+        pthread_cond_broadcast(&scan.start);
+        pthread_mutex_unlock(&scan.lock);
+    }
+
+    scan_worker_run(0);
+
+    if (scan.workers > 1) {
+        pthread_mutex_lock(&scan.lock);
+        while (scan.pending > 0) {
+            pthread_cond_wait(&scan.done, &scan.lock);
+        }
+        pthread_mutex_unlock(&scan.lock);
+    }
+
+    // Merge: squeeze out the entries whose process vanished mid-scan
+    int num_processes = 0;
+    for (int i = 0; i < entry_count; i++) {
+        if (processes[i].pid == 0) continue;
+        if (num_processes != i) {
+            processes[num_processes] = processes[i];
+        }
+        num_processes++;
+    }
+
+    *count = num_processes;
+    return 0;
+}
+
+// Get list of all processes
+int get_process_list(ProcessInfo **processes, int *count, int max_processes) {
+    *processes = NULL;
+    int entry_count = list_proc_entries(max_processes);
+    if (entry_count < 0) {
+        return -1;
+    }
+
+    // Allocate memory for the process list
+    *processes = calloc(entry_count > 0 ? entry_count : 1, sizeof(ProcessInfo));
+    if (!*processes) {
+        fprintf(stderr, "Failed to allocate memory for process list\n");
+        return -1;
+    }
+
+    return run_scan(entry_count, *processes, count);
+}
+
+// Refresh only the given PIDs, skipping the /proc directory listing
+int get_process_list_for(const TrackedPid *pids, int npids,
+                         ProcessInfo **processes, int *count, int max_processes) {
+    unsigned long syscalls = 0;
+
+    if (npids > max_processes) npids = max_processes;
+    *processes = calloc(npids > 0 ? npids : 1, sizeof(ProcessInfo));
+    if (!*processes) {
+        fprintf(stderr, "Failed to allocate memory for process list\n");
+        return -1;
+    }
+
+    if (reserve_entries(npids) != 0 || open_proc_dir(false, &syscalls) != 0) {
+        free(*processes);
+        *processes = NULL;
+        return -1;
+    }
+
+    for (int i = 0; i < npids; i++) {
+        ProcEntry *entry = &scan.entries[i];
+        entry->pid = pids[i].pid;
+        entry->uid = pids[i].uid;
+        entry->need_owner = !pids[i].known_owner;
+        snprintf(entry->name, sizeof(entry->name), "%d", (int)pids[i].pid);
+    }
+
+    scan.list_syscalls = syscalls;
+    return run_scan(npids, *processes, count);
+}
+
+// Syscalls issued by the most recent get_process_list call
+unsigned long process_scan_syscalls(void) {
+    unsigned long total = scan.list_syscalls;
+    for (int w = 0; w < scan.workers; w++) {
+        total += scan.stats[w].syscalls;
+    }
+    return total;
+}
@@ -0,0 +1,102 @@
+#include "../../include/procfs_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#define PROCFS_INITIAL_BUFFER 4096
+
+// Re-read a cached file from offset 0.
+// Returns the NUL-terminated contents, or NULL on error.
+const char *procfs_read(ProcFile *file) {
+    if (file->fd < 0) {
+        file->fd = open(file->path, O_RDONLY | O_CLOEXEC);
+        if (file->fd < 0) {
+            fprintf(stderr, "Error opening %s: %s\n", file->path, strerror(errno));
+            return NULL;
+        }
+    }
+
+    if (!file->buf) {
+        file->buf = malloc(PROCFS_INITIAL_BUFFER);
+        if (!file->buf) {
+            fprintf(stderr, "Failed to allocate buffer for %s\n", file->path);
+            return NULL;
+        }
+        file->cap = PROCFS_INITIAL_BUFFER;
+    }
+
+    file->len = 0;
+    for (;;) {
+        size_t room = file->cap - 1 - file->len;
+        ssize_t n = pread(file->fd, file->buf + file->len, room, (off_t)file->len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error reading %s: %s\n", file->path, strerror(errno));
+            // Reopen on the next sample in case the file went away
+            close(file->fd);
+            file->fd = -1;
+            return NULL;
+        }
+
+        file->len += (size_t)n;
+        // seq_file fills the whole request unless it hit the end
+        if ((size_t)n < room) break;
+
+        // Buffer was too small: grow it and keep reading where we left off.
+        // The larger size sticks, so later samples are back to one pread.
+        char *grown = realloc(file->buf, file->cap * 2);
+        if (!grown) {
+            fprintf(stderr, "Failed to grow buffer for %s\n", file->path);
+            return NULL;
+        }
+        file->buf = grown;
+        file->cap *= 2;
+    }
+
+    file->buf[file->len] = '\0';
+    return file->buf;
+}
+
+// Close the descriptor and release the buffer
+void procfs_close(ProcFile *file) {
+    if (file->fd >= 0) {
+        close(file->fd);
+        file->fd = -1;
+    }
+    free(file->buf);
+    file->buf = NULL;
+    file->cap = 0;
+    file->len = 0;
+}
+
+// Parse the next unsigned decimal number, skipping leading blanks.
+// Advances *cursor past the digits; returns 0 if there is no number.
+unsigned long procfs_next_ulong(const char **cursor) {
+    const char *p = *cursor;
+    unsigned long value = 0;
+
+    while (*p == ' ' || *p == '\t') p++;
+    while ((unsigned)(*p - '0') < 10) {
+        value = value * 10 + (unsigned long)(*p - '0');
+        p++;
+    }
+
+    *cursor = p;
+    return value;
+}
+
+// Skip blanks and then one whitespace-delimited field
+const char *procfs_skip_field(const char *p) {
+    while (*p == ' ' || *p == '\t') p++;
+    while (*p && *p != ' ' && *p != '\t' && *p != '\n') p++;
+    return p;
+}
+
+// Start of the following line, or NULL at the end of the buffer
+const char *procfs_next_line(const char *p) {
+    p = strchr(p, '\n');
+    return (p && p[1]) ? p + 1 : NULL;
+}